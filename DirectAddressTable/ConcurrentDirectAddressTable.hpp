@@ -0,0 +1,195 @@
+/**
+ * ------- Concurrent Direct Address Table ----------
+ * A DirectAddressTable many threads can Insert() into,
+ * Delete() from and Search() at the same time.
+ *
+ * Insert() - lock-free - O(1) expected
+ * Delete() - lock-free - O(1) expected
+ * Search() - wait-free - O(1)
+ *
+ * Keys are the same {index, generation} handles as in
+ * DirectAddressTable: a generation is odd exactly while
+ * its slot is occupied.
+ *
+ * Slots are handed out from an atomic bump counter until
+ * the universe is used up, then from a lock-free stack of
+ * vacated slots. The stack head carries a tag that changes
+ * on every push and pop, so a thread that read a stale head
+ * cannot win the compare-and-swap (no ABA).
+ *
+ * Search() is a seqlock read: load the generation, copy the
+ * value, re-load the generation. A concurrent Delete() (and
+ * any reuse of the slot) bumps the generation, so a torn
+ * copy is never returned. Values are copied word by word
+ * through atomics, which keeps the read race-free and
+ * restricts Value to trivially copyable types.
+ */
+
+#ifndef DIRECTADDRESSTABLE_CONCURRENTDIRECTADDRESSTABLE_H
+#define DIRECTADDRESSTABLE_CONCURRENTDIRECTADDRESSTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DirectAddressTable.hpp"
+
+template <typename Value>
+class ConcurrentDirectAddressTable {
+    static_assert(std::is_trivially_copyable_v<Value>, "values are copied with a seqlock read");
+
+public:
+    using key_type = direct_address::Key;
+    using index_type = direct_address::index_type;
+    using generation_type = direct_address::generation_type;
+    static constexpr key_type invalid_key {};
+
+    explicit ConcurrentDirectAddressTable(std::size_t universe);
+    /// slots are shared by reference between threads, never copied
+    ConcurrentDirectAddressTable(const ConcurrentDirectAddressTable&) = delete;
+    ConcurrentDirectAddressTable& operator=(const ConcurrentDirectAddressTable&) = delete;
+
+    /// store value, return its key (invalid_key once the universe is full)
+    key_type Insert(const Value&);
+    /// vacate the slot; false if k was already deleted or stale
+    bool Delete(key_type);
+    /// copy the satellite under k into out; false if k is not live
+    bool Search(key_type, Value& out) const;
+
+    std::size_t universe() const { return universe_size; }
+
+private:
+    static constexpr std::size_t value_words = (sizeof(Value) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct Slot {
+        std::atomic<generation_type> generation { 0 };
+        std::atomic<index_type> next_free { direct_address::no_slot };
+        std::atomic<std::uint64_t> words[value_words] {};
+    };
+
+    /// free-list head: slot index in the low half, ABA tag in the high half
+    static index_type index_of(std::uint64_t head) { return static_cast<index_type>(head); }
+    static std::uint64_t tagged(index_type i, std::uint64_t head) { return ((head >> 32) + 1) << 32 | i; }
+
+    index_type pop_free();
+    void push_free(index_type);
+    index_type allocate();
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t universe_size;
+    /// slots [bump, universe) have never been handed out
+    alignas(64) std::atomic<std::size_t> bump { 0 };
+    alignas(64) std::atomic<std::uint64_t> free_head { direct_address::no_slot };
+};
+
+template <typename Value>
+ConcurrentDirectAddressTable<Value>::ConcurrentDirectAddressTable(std::size_t universe)
+    : universe_size(universe)
+{
+    if (universe_size > direct_address::max_universe)
+        throw std::length_error("ConcurrentDirectAddressTable: universe does not fit a 32-bit index");
+    slots = std::make_unique<Slot[]>(universe_size);
+}
+
+template <typename Value>
+void ConcurrentDirectAddressTable<Value>::push_free(index_type i)
+{
+    auto head = free_head.load(std::memory_order_relaxed);
+    do {
+        slots[i].next_free.store(index_of(head), std::memory_order_relaxed);
+    } while (!free_head.compare_exchange_weak(head, tagged(i, head),
+        std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <typename Value>
+typename ConcurrentDirectAddressTable<Value>::index_type ConcurrentDirectAddressTable<Value>::pop_free()
+{
+    auto head = free_head.load(std::memory_order_acquire);
+    while (index_of(head) != direct_address::no_slot) {
+        /// may read a link another thread is rewriting; the tag then
+        /// makes the compare-and-swap below fail and we retry
+        auto next = slots[index_of(head)].next_free.load(std::memory_order_relaxed);
+        if (free_head.compare_exchange_weak(head, tagged(next, head),
+                std::memory_order_acquire, std::memory_order_acquire))
+            return index_of(head);
+    }
+    return direct_address::no_slot;
+}
+
+template <typename Value>
+typename ConcurrentDirectAddressTable<Value>::index_type ConcurrentDirectAddressTable<Value>::allocate()
+{
+    /// fresh slots first, as in DirectAddressTable; the load keeps a
+    /// full table from pushing the counter ever further past the end
+    if (bump.load(std::memory_order_relaxed) < universe_size) {
+        auto i = bump.fetch_add(1, std::memory_order_relaxed);
+        if (i < universe_size)
+            return static_cast<index_type>(i);
+    }
+    return pop_free();
+}
+
+template <typename Value>
+typename ConcurrentDirectAddressTable<Value>::key_type ConcurrentDirectAddressTable<Value>::Insert(const Value& value)
+{
+    auto i = allocate();
+    if (i == direct_address::no_slot)
+        return invalid_key;
+
+    /// the slot is ours alone until its generation is published
+    auto& slot = slots[i];
+    auto g = slot.generation.load(std::memory_order_relaxed) + 1;
+
+    std::uint64_t buffer[value_words] {};
+    std::memcpy(buffer, &value, sizeof(Value));
+    /// a reader still holding a key to the slot's previous tenant must
+    /// see the Delete() generation if it sees any of these words
+    for (std::size_t w = 0; w < value_words; ++w)
+        slot.words[w].store(buffer[w], std::memory_order_release);
+
+    slot.generation.store(g, std::memory_order_release);
+    return { i, g };
+}
+
+template <typename Value>
+bool ConcurrentDirectAddressTable<Value>::Delete(key_type k)
+{
+    if (k.index >= universe_size || !(k.generation & 1))
+        return false;
+
+    /// exactly one of several racing deleters wins the slot
+    auto g = k.generation;
+    if (!slots[k.index].generation.compare_exchange_strong(g, g + 1, std::memory_order_acq_rel))
+        return false;
+
+    push_free(k.index);
+    return true;
+}
+
+template <typename Value>
+bool ConcurrentDirectAddressTable<Value>::Search(key_type k, Value& out) const
+{
+    if (k.index >= universe_size || !(k.generation & 1))
+        return false;
+
+    auto& slot = slots[k.index];
+    if (slot.generation.load(std::memory_order_acquire) != k.generation)
+        return false;
+
+    std::uint64_t buffer[value_words];
+    for (std::size_t w = 0; w < value_words; ++w)
+        buffer[w] = slot.words[w].load(std::memory_order_acquire);
+
+    /// if the slot changed hands while we copied, the copy may be torn
+    if (slot.generation.load(std::memory_order_relaxed) != k.generation)
+        return false;
+
+    std::memcpy(&out, buffer, sizeof(Value));
+    return true;
+}
+
+#endif //DIRECTADDRESSTABLE_CONCURRENTDIRECTADDRESSTABLE_H
@@ -0,0 +1,186 @@
+/// Multi-threaded slot churn: ConcurrentDirectAddressTable vs a
+/// DirectAddressTable behind a std::mutex.
+///
+/// usage: ConcurrentDirectAddressTable_bench [--stress] [max_threads] [ops_per_thread]
+/// g++ -std=c++17 -O2 -pthread ConcurrentDirectAddressTable_bench.cc
+///
+/// --stress skips the timings and hammers one small table from every
+/// thread, checking that no lookup ever returns a torn, stale or foreign
+/// value: every Session carries the thread that inserted it, a published
+/// key only ever resolves to its owner's value and a key that was deleted
+/// never resolves again, however often its slot has changed hands. Build it under ThreadSanitizer to check the memory ordering:
+/// g++ -std=c++17 -O1 -g -fsanitize=thread -pthread ConcurrentDirectAddressTable_bench.cc
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentDirectAddressTable.hpp"
+#include "DirectAddressTable.hpp"
+
+/// two words that must always be read together: b == ~a
+struct Session {
+    std::uint64_t a;
+    std::uint64_t b;
+};
+
+Session make_session(std::uint64_t owner, std::uint64_t serial)
+{
+    auto a = owner << 48 | serial;
+    return { a, ~a };
+}
+
+std::uint64_t owner_of(const Session& s) { return s.a >> 48; }
+
+/// how many keys each thread keeps live while it churns
+constexpr std::size_t working_set = 64;
+/// how many of its deleted keys each stress thread keeps probing
+constexpr std::size_t stale_history = 256;
+
+template <typename F>
+double run_threads(unsigned threads, F&& body)
+{
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back(body, t);
+    for (auto& thread : pool)
+        thread.join();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+void bench(unsigned max_threads, std::size_t ops)
+{
+    for (unsigned threads = 1; threads <= max_threads; ++threads) {
+        auto universe = threads * working_set * 2;
+
+        ConcurrentDirectAddressTable<Session> lock_free(universe);
+        auto lock_free_ns = run_threads(threads, [&](unsigned t) {
+            std::vector<direct_address::Key> keys(working_set);
+            for (auto& k : keys)
+                k = lock_free.Insert(make_session(t, 0));
+            Session s;
+            for (std::size_t op = 0; op < ops; ++op) {
+                auto& k = keys[op % working_set];
+                lock_free.Search(k, s);
+                lock_free.Delete(k);
+                k = lock_free.Insert(make_session(t, op));
+            }
+        });
+
+        DirectAddressTable<Session> locked(universe);
+        std::mutex mutex;
+        auto locked_ns = run_threads(threads, [&](unsigned t) {
+            std::vector<DirectAddressTable<Session>::Entry> entries(working_set);
+            for (auto& e : entries) {
+                e.satellite = make_session(t, 0);
+                std::lock_guard<std::mutex> lock(mutex);
+                locked.Insert(e);
+            }
+            Session s;
+            for (std::size_t op = 0; op < ops; ++op) {
+                auto& e = entries[op % working_set];
+                e.satellite = make_session(t, op);
+                std::lock_guard<std::mutex> lock(mutex);
+                s = *locked.Search(e);
+                locked.Delete(e);
+                locked.Insert(e);
+            }
+        });
+
+        /// each op is a search, a delete and an insert
+        auto total = 3.0 * ops * threads;
+        std::cout << threads << " thread(s): lock-free " << lock_free_ns / total << " ns/op ("
+                  << total / lock_free_ns * 1e3 << " Mops/s), mutex " << locked_ns / total << " ns/op ("
+                  << total / locked_ns * 1e3 << " Mops/s)\n";
+    }
+}
+
+int stress(unsigned threads, std::size_t ops)
+{
+    /// a universe barely larger than the working sets keeps the free
+    /// list hot and slots changing hands between threads constantly
+    ConcurrentDirectAddressTable<Session> table(threads * working_set + 1);
+    std::vector<std::atomic<std::uint64_t>> published(threads * working_set);
+    std::atomic<std::size_t> failures { 0 };
+
+    auto pack = [](direct_address::Key k) { return std::uint64_t(k.generation) << 32 | k.index; };
+    auto unpack = [](std::uint64_t v) { return direct_address::Key { static_cast<std::uint32_t>(v), static_cast<std::uint32_t>(v >> 32) }; };
+
+    run_threads(threads, [&](unsigned t) {
+        std::mt19937 rng(t);
+        std::vector<direct_address::Key> keys(working_set);
+        std::vector<Session> mine(working_set);
+        std::vector<direct_address::Key> deleted;
+        deleted.reserve(stale_history);
+        for (std::size_t i = 0; i < working_set; ++i) {
+            mine[i] = make_session(t, i);
+            keys[i] = table.Insert(mine[i]);
+            if (keys[i] == decltype(table)::invalid_key)
+                ++failures;
+            published[t * working_set + i].store(pack(keys[i]), std::memory_order_relaxed);
+        }
+
+        Session s;
+        for (std::size_t op = 0; op < ops; ++op) {
+            auto i = op % working_set;
+
+            /// our own keys always resolve to exactly what we stored
+            if (!table.Search(keys[i], s) || s.a != mine[i].a || s.b != mine[i].b)
+                ++failures;
+
+            /// someone else's key may be gone, but never torn and never
+            /// anyone's value but the thread that published it
+            auto j = rng() % published.size();
+            auto other = unpack(published[j].load(std::memory_order_relaxed));
+            if (table.Search(other, s) && (s.b != ~s.a || owner_of(s) != j / working_set))
+                ++failures;
+
+            /// a key we deleted a while ago misses, whoever holds its slot now
+            if (!deleted.empty() && table.Search(deleted[rng() % deleted.size()], s))
+                ++failures;
+
+            auto stale = keys[i];
+            if (!table.Delete(keys[i]) || table.Delete(stale) || table.Search(stale, s))
+                ++failures;
+            if (deleted.size() < stale_history)
+                deleted.push_back(stale);
+            else
+                deleted[rng() % stale_history] = stale;
+
+            mine[i] = make_session(t, op + working_set);
+            keys[i] = table.Insert(mine[i]);
+            if (keys[i] == decltype(table)::invalid_key)
+                ++failures;
+            published[t * working_set + i].store(pack(keys[i]), std::memory_order_relaxed);
+        }
+    });
+
+    std::cout << "stress: " << threads << " threads x " << ops << " ops, "
+              << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    int arg = 1;
+    bool stress_mode = argc > 1 && std::string(argv[1]) == "--stress";
+    if (stress_mode)
+        ++arg;
+    unsigned max_threads = argc > arg ? std::stoul(argv[arg]) : std::max(2u, std::thread::hardware_concurrency());
+    std::size_t ops = argc > arg + 1 ? std::stoull(argv[arg + 1]) : 1000000;
+
+    if (stress_mode)
+        return stress(max_threads, ops);
+    bench(max_threads, ops);
+    return 0;
+}
@@ -0,0 +1,711 @@
+/**
+ * ------------- Direct Address Table ---------------
+ * Direct addressing works well when the universe of
+ * keys is reasonably small.
+ *
+ * There are a finite number of unique keys. When
+ * deletions are made keys are reclaimed to be
+ * reused.
+ *
+ * Delete() - Worst Case - O(1)
+ * Insert() - Worst Case - O(1)
+ * Search() - Worst Case - O(1)
+ *
+ * DirectAddressTable<Value, Universe> keeps its slots in a
+ * std::array sized at compile time. DirectAddressTable<Value>
+ * (Universe == dynamic_universe) takes the universe at run time
+ * and keeps slots and occupancy in one aligned allocation.
+ *
+ * Occupancy is tracked in a bitmap beside the slots rather than
+ * with a {-1, -1} sentinel, so every Value is a legal satellite.
+ * Slots hold raw storage; a Value is constructed on Insert() and
+ * destroyed on Delete().
+ *
+ * Keys are {index, generation} handles (a "slot map"). Every slot
+ * carries a generation counter that is bumped on Insert() and on
+ * Delete(), so it is odd exactly while the slot is occupied and a
+ * stale key to a reused slot misses in O(1). Vacant slots double as
+ * the nodes of the free list: no allocation on Insert() or Delete().
+ *
+ * Above the occupancy bitmap sit two summary bitmaps with one bit per
+ * occupancy word: "has a live slot" and "has no vacant slot". Walking
+ * live satellites (for_each) and finding the next vacant slot
+ * (find_first_free) skip 4096 slots per summary word and then use
+ * tzcnt within a word, so sweeps cost O(live + universe / 4096).
+ * size() is a counter. compact() packs live satellites into
+ * [0, size()) and reports the new key of every old one.
+ *
+ * search_batch() resolves many keys at once. With AVX2 and a 32-bit
+ * trivially copyable Value it checks and gathers eight keys per step;
+ * otherwise it prefetches slots a few keys ahead of the lookup.
+ *
+ * Eric Sanchez @ericdeansanchez on 20180524
+ */
+
+#ifndef DIRECTADDRESSTABLE_DIRECTADDRESSTABLE_H
+#define DIRECTADDRESSTABLE_DIRECTADDRESSTABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Instrumentation.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+constexpr std::size_t dynamic_universe = static_cast<std::size_t>(-1);
+
+namespace direct_address {
+
+using index_type = std::uint32_t;
+using generation_type = std::uint32_t;
+
+/// end of the free list, and the index of a key that names no slot
+constexpr index_type no_slot = static_cast<index_type>(-1);
+/// the largest universe a 32-bit index can address next to no_slot
+constexpr std::size_t max_universe = no_slot;
+
+/// a handle to one occupied slot
+struct Key {
+    index_type index = no_slot;
+    generation_type generation = 0;
+};
+
+inline bool operator==(const Key& a, const Key& b) { return a.index == b.index && a.generation == b.generation; }
+inline bool operator!=(const Key& a, const Key& b) { return !(a == b); }
+
+/// slot bookkeeping; kept by the storage so a mapped table can keep
+/// it in its file next to the slots it describes
+struct TableState {
+    /// slots [key, universe) have never been handed out
+    std::uint64_t key = 0;
+    /// live satellites
+    std::uint64_t live_count = 0;
+    /// most recently vacated slot, threaded through Slot::next_free
+    index_type free_head = no_slot;
+};
+
+/// occupancy is one bit per slot, packed into 64-bit words
+constexpr std::size_t word_bits = 64;
+constexpr std::size_t words_for(std::size_t universe) { return (universe + word_bits - 1) / word_bits; }
+/// summaries are one bit per occupancy word
+constexpr std::size_t summary_words_for(std::size_t universe) { return words_for(words_for(universe)); }
+/// occupancy words followed by the "nonempty" and "full" summaries
+constexpr std::size_t bitmap_words_for(std::size_t universe) { return words_for(universe) + 2 * summary_words_for(universe); }
+
+/// room for one Value while occupied, the next free slot while vacant.
+/// The generation follows the value bytes: for small Values both share
+/// a cache line and a lookup misses once, while a Value of most of a
+/// line or more puts the generation check on a line of its own
+template <typename Value>
+struct Slot {
+    union {
+        alignas(Value) unsigned char bytes[sizeof(Value)];
+        index_type next_free;
+    };
+    generation_type generation;
+};
+
+/// slots and bitmaps live inside the table itself
+template <typename Value, std::size_t Universe>
+struct FixedStorage {
+    static_assert(Universe <= max_universe, "universe does not fit a 32-bit index");
+
+    explicit FixedStorage(std::size_t) { }
+    FixedStorage(const FixedStorage&) = delete;
+    FixedStorage& operator=(const FixedStorage&) = delete;
+
+    std::size_t universe() const { return Universe; }
+    Slot<Value>* slots() { return slot_array.data(); }
+    const Slot<Value>* slots() const { return slot_array.data(); }
+    std::uint64_t* occupancy() { return bitmap_words.data(); }
+    const std::uint64_t* occupancy() const { return bitmap_words.data(); }
+    TableState& state() { return table_state; }
+    const TableState& state() const { return table_state; }
+
+    std::array<Slot<Value>, Universe> slot_array {};
+    std::array<std::uint64_t, bitmap_words_for(Universe)> bitmap_words {};
+    TableState table_state;
+};
+
+/// one cache-line aligned block: [slots][occupancy words][summaries]
+template <typename Value>
+struct DynamicStorage {
+    static constexpr std::size_t alignment = alignof(Slot<Value>) > 64 ? alignof(Slot<Value>) : 64;
+
+    explicit DynamicStorage(std::size_t universe)
+        : universe_size(universe)
+    {
+        if (universe_size > max_universe)
+            throw std::length_error("DirectAddressTable: universe does not fit a 32-bit index");
+        /// an empty universe (e.g. a table about to be moved into) owns nothing
+        if (universe_size == 0)
+            return;
+        block = static_cast<unsigned char*>(::operator new(bytes(), std::align_val_t(alignment)));
+        std::memset(block, 0, bytes());
+    }
+    DynamicStorage(const DynamicStorage&) = delete;
+    DynamicStorage& operator=(const DynamicStorage&) = delete;
+    DynamicStorage(DynamicStorage&& rhs) noexcept
+        : block(std::exchange(rhs.block, nullptr))
+        , universe_size(std::exchange(rhs.universe_size, 0))
+        , table_state(std::exchange(rhs.table_state, {}))
+    {
+    }
+    DynamicStorage& operator=(DynamicStorage&& rhs) noexcept
+    {
+        std::swap(block, rhs.block);
+        std::swap(universe_size, rhs.universe_size);
+        std::swap(table_state, rhs.table_state);
+        return *this;
+    }
+    ~DynamicStorage()
+    {
+        if (block)
+            ::operator delete(block, std::align_val_t(alignment));
+    }
+
+    std::size_t universe() const { return universe_size; }
+    Slot<Value>* slots() { return reinterpret_cast<Slot<Value>*>(block); }
+    const Slot<Value>* slots() const { return reinterpret_cast<const Slot<Value>*>(block); }
+    std::uint64_t* occupancy() { return reinterpret_cast<std::uint64_t*>(block + occupancy_offset()); }
+    const std::uint64_t* occupancy() const { return reinterpret_cast<const std::uint64_t*>(block + occupancy_offset()); }
+    TableState& state() { return table_state; }
+    const TableState& state() const { return table_state; }
+
+    std::size_t occupancy_offset() const
+    {
+        auto offset = universe_size * sizeof(Slot<Value>);
+        return (offset + alignof(std::uint64_t) - 1) & ~(alignof(std::uint64_t) - 1);
+    }
+    std::size_t bytes() const { return occupancy_offset() + bitmap_words_for(universe_size) * sizeof(std::uint64_t); }
+
+    unsigned char* block = nullptr;
+    std::size_t universe_size = 0;
+    TableState table_state;
+};
+
+template <typename Value, std::size_t Universe>
+using storage_for = std::conditional_t<Universe == dynamic_universe,
+    DynamicStorage<Value>, FixedStorage<Value, Universe>>;
+
+} // namespace direct_address
+
+/// Storage provides universe(), slots(), occupancy() (bitmap and
+/// summaries) and state(); see also MappedDirectAddressTable.hpp.
+/// Instrument is a policy from Instrumentation.hpp
+template <typename Value, std::size_t Universe = dynamic_universe,
+    typename Storage = direct_address::storage_for<Value, Universe>, typename Instrument = NoInstrumentation>
+class DirectAddressTable : private Instrument {
+public:
+    using key_type = direct_address::Key;
+    using index_type = direct_address::index_type;
+    static constexpr key_type invalid_key {};
+
+    struct Entry {
+        Value satellite;
+        key_type key = invalid_key;
+    };
+
+    /// compile-time universe
+    DirectAddressTable();
+    /// run-time universe
+    explicit DirectAddressTable(std::size_t universe);
+    /// copy constructor
+    DirectAddressTable(const DirectAddressTable&);
+    /// copy assignment
+    DirectAddressTable& operator=(const DirectAddressTable&);
+    /// move constructor
+    DirectAddressTable(DirectAddressTable&&) noexcept(Universe == dynamic_universe);
+    /// move assignment
+    DirectAddressTable& operator=(DirectAddressTable&&) noexcept(Universe == dynamic_universe);
+    /// destroy live satellites
+    ~DirectAddressTable() { destroy_satellites(); }
+
+    void Delete(Entry&);
+    void Insert(Entry&);
+    /// satellite stored under entry.key, or nullptr
+    const Value* Search(const Entry&) const;
+    Value* Search(key_type);
+    const Value* Search(key_type) const;
+    /// for each keys[i] that is live copy its satellite to out[i] and set
+    /// bit i of found (n bits, rounded up to whole words); leave misses
+    /// in out untouched; return the number of hits
+    std::size_t search_batch(const key_type* keys, std::size_t n, Value* out, std::uint64_t* found) const;
+
+    /// is the key's index in range [0, universe)
+    bool valid(key_type k) const { return k.index < universe(); }
+    /// does the key still name a live satellite (not deleted, not reused)
+    bool occupied(key_type k) const { return valid(k) && live(k.index, k.generation); }
+    std::size_t universe() const { return storage.universe(); }
+    /// number of live satellites
+    std::size_t size() const { return storage.state().live_count; }
+    bool empty() const { return size() == 0; }
+    /// destroy every satellite; outstanding keys all become stale
+    void clear();
+
+    /// first occupied index at or after pos, universe() if there is none
+    std::size_t find_next_occupied(std::size_t pos) const { return scan<false>(pos); }
+    /// first vacant index at or after pos, universe() if there is none
+    std::size_t find_first_free(std::size_t pos) const { return scan<true>(pos); }
+    /// call f(key, satellite) for every live satellite, in index order
+    template <typename F>
+    void for_each(F&& f);
+    template <typename F>
+    void for_each(F&& f) const;
+    /// move every satellite down into [0, size()), keeping their order;
+    /// element i of the result is the new key of the satellite that was
+    /// at index i (invalid_key if there was none). Keys of satellites that
+    /// moved become stale; a satellite already in place keeps its key.
+    /// Value must be nothrow move constructible, so a compaction cannot
+    /// stop halfway with the free list describing the old layout.
+    std::vector<key_type> compact();
+
+    /// the instrumentation policy, e.g. its stats()
+    const Instrument& instrumentation() const { return *this; }
+    /// zero the policy's stats(), e.g. after an export
+    void reset_instrumentation() { this->reset_stats(); }
+
+protected:
+    /// adopt storage that already holds a table (e.g. a mapped file)
+    explicit DirectAddressTable(Storage&& s)
+        : storage(std::move(s))
+    {
+    }
+
+    Storage storage;
+
+private:
+    /// movable storage travels whole; fixed storage starts empty
+    static Storage take(Storage& s);
+
+    direct_address::TableState& state() { return storage.state(); }
+    const direct_address::TableState& state() const { return storage.state(); }
+    void destroy_satellites();
+    void reuse_key_on(Entry&);
+    void place(Entry&, index_type);
+
+    Value* value_at(index_type i) { return std::launder(reinterpret_cast<Value*>(storage.slots()[i].bytes)); }
+    const Value* value_at(index_type i) const { return std::launder(reinterpret_cast<const Value*>(storage.slots()[i].bytes)); }
+
+    /// generations are odd exactly while a slot is occupied
+    bool live(index_type i, direct_address::generation_type g) const { return storage.slots()[i].generation == g && (g & 1); }
+
+    std::uint64_t* nonempty() { return storage.occupancy() + direct_address::words_for(universe()); }
+    const std::uint64_t* nonempty() const { return storage.occupancy() + direct_address::words_for(universe()); }
+    std::uint64_t* full() { return nonempty() + direct_address::summary_words_for(universe()); }
+    const std::uint64_t* full() const { return nonempty() + direct_address::summary_words_for(universe()); }
+
+    /// mark slot i occupied / vacant, keeping both summaries in step
+    void set(index_type i);
+    void reset(index_type i);
+    /// shared by find_next_occupied (Free = false) and find_first_free
+    template <bool Free>
+    std::size_t scan(std::size_t pos) const;
+    /// call f(index) for every occupied slot; f may vacate the slot it is
+    /// given and occupy slots below it
+    template <typename F>
+    void each_occupied(F&& f) const;
+
+    std::size_t search_batch_scalar(const key_type*, std::size_t, std::size_t, Value*, std::uint64_t*) const;
+
+    /// take over every slot of rhs: satellites, generations and free list
+    template <typename Source>
+    void adopt(Source&& rhs);
+};
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+DirectAddressTable<Value, Universe, Storage, Instrument>::DirectAddressTable()
+    : storage(Universe)
+{
+    static_assert(Universe != dynamic_universe, "a run-time sized table needs a universe");
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+DirectAddressTable<Value, Universe, Storage, Instrument>::DirectAddressTable(std::size_t universe)
+    : storage(universe)
+{
+    static_assert(Universe == dynamic_universe, "universe is fixed at compile time");
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+DirectAddressTable<Value, Universe, Storage, Instrument>::DirectAddressTable(const DirectAddressTable& rhs)
+    : Instrument(rhs)
+    , storage(rhs.universe())
+{
+    adopt(rhs);
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+DirectAddressTable<Value, Universe, Storage, Instrument>& DirectAddressTable<Value, Universe, Storage, Instrument>::operator=(const DirectAddressTable& rhs)
+{
+    if (this != &rhs) {
+        clear();
+        if constexpr (Universe == dynamic_universe) {
+            if (universe() != rhs.universe())
+                storage = Storage(rhs.universe());
+        }
+        adopt(rhs);
+    }
+    return *this;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+Storage DirectAddressTable<Value, Universe, Storage, Instrument>::take(Storage& s)
+{
+    if constexpr (Universe == dynamic_universe)
+        return std::move(s);
+    else
+        return Storage(s.universe());
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+DirectAddressTable<Value, Universe, Storage, Instrument>::DirectAddressTable(DirectAddressTable&& rhs) noexcept(Universe == dynamic_universe)
+    : Instrument(rhs)
+    , storage(take(rhs.storage))
+{
+    /// slots, bitmaps and state moved with the storage unless it is fixed
+    if constexpr (Universe != dynamic_universe) {
+        adopt(std::move(rhs));
+        rhs.clear();
+    }
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+DirectAddressTable<Value, Universe, Storage, Instrument>& DirectAddressTable<Value, Universe, Storage, Instrument>::operator=(DirectAddressTable&& rhs) noexcept(Universe == dynamic_universe)
+{
+    /// adjust for possible self assignment
+    if (this != &rhs) {
+        clear();
+        if constexpr (Universe == dynamic_universe) {
+            std::swap(storage, rhs.storage);
+        } else {
+            adopt(std::move(rhs));
+            rhs.clear();
+        }
+    }
+    return *this;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+template <typename Source>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::adopt(Source&& rhs)
+{
+    auto slots = storage.slots();
+    auto rhs_slots = rhs.storage.slots();
+    for (std::size_t i = 0; i < rhs.state().key; ++i) {
+        if (rhs_slots[i].generation & 1) {
+            if constexpr (std::is_lvalue_reference_v<Source>)
+                new (slots[i].bytes) Value(*rhs.value_at(i));
+            else
+                new (slots[i].bytes) Value(std::move(*rhs.value_at(i)));
+            set(i);
+        } else {
+            slots[i].next_free = rhs_slots[i].next_free;
+        }
+        slots[i].generation = rhs_slots[i].generation;
+    }
+    state() = rhs.state();
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::destroy_satellites()
+{
+    if constexpr (!std::is_trivially_destructible_v<Value>)
+        each_occupied([&](index_type i) { value_at(i)->~Value(); });
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::clear()
+{
+    destroy_satellites();
+    each_occupied([&](index_type i) { ++storage.slots()[i].generation; });
+    std::fill(storage.occupancy(), storage.occupancy() + direct_address::bitmap_words_for(universe()), std::uint64_t(0));
+    /// generations are kept, so handing slots out again from 0 cannot
+    /// revive a key issued before the clear
+    state() = {};
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::set(index_type i)
+{
+    auto w = i / direct_address::word_bits;
+    auto summary_bit = std::uint64_t(1) << (w % direct_address::word_bits);
+    auto& word = storage.occupancy()[w];
+    word |= std::uint64_t(1) << (i % direct_address::word_bits);
+    nonempty()[w / direct_address::word_bits] |= summary_bit;
+    if (word == ~std::uint64_t(0))
+        full()[w / direct_address::word_bits] |= summary_bit;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::reset(index_type i)
+{
+    auto w = i / direct_address::word_bits;
+    auto summary_bit = std::uint64_t(1) << (w % direct_address::word_bits);
+    auto& word = storage.occupancy()[w];
+    word &= ~(std::uint64_t(1) << (i % direct_address::word_bits));
+    full()[w / direct_address::word_bits] &= ~summary_bit;
+    if (word == 0)
+        nonempty()[w / direct_address::word_bits] &= ~summary_bit;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+template <bool Free>
+std::size_t DirectAddressTable<Value, Universe, Storage, Instrument>::scan(std::size_t pos) const
+{
+    using direct_address::word_bits;
+    /// looking for vacant slots is looking for set bits of the complement
+    auto flip = [](std::uint64_t bits) { return Free ? ~bits : bits; };
+    auto words = storage.occupancy();
+    auto summary = Free ? full() : nonempty();
+    auto word_count = direct_address::words_for(universe());
+    auto summary_count = direct_address::summary_words_for(universe());
+
+    if (pos >= universe())
+        return universe();
+
+    /// rest of the word holding pos
+    auto w = pos / word_bits;
+    auto bits = flip(words[w]) & (~std::uint64_t(0) << (pos % word_bits));
+    if (!bits) {
+        /// next candidate word, found through the summary
+        auto next = w + 1;
+        if (next >= word_count)
+            return universe();
+        auto s = next / word_bits;
+        auto candidates = flip(summary[s]) & (~std::uint64_t(0) << (next % word_bits));
+        while (!candidates) {
+            if (++s >= summary_count)
+                return universe();
+            candidates = flip(summary[s]);
+        }
+        w = s * word_bits + __builtin_ctzll(candidates);
+        if (w >= word_count)
+            return universe();
+        bits = flip(words[w]);
+    }
+    /// a vacant bit past the end of the last word is not a slot
+    return std::min<std::size_t>(w * word_bits + __builtin_ctzll(bits), universe());
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+template <typename F>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::each_occupied(F&& f) const
+{
+    using direct_address::word_bits;
+    auto words = storage.occupancy();
+    auto summary = nonempty();
+    for (std::size_t s = 0; s < direct_address::summary_words_for(universe()); ++s) {
+        /// copies: f may clear bits of the words we are walking
+        for (auto candidates = summary[s]; candidates; candidates &= candidates - 1) {
+            auto w = s * word_bits + __builtin_ctzll(candidates);
+            for (auto bits = words[w]; bits; bits &= bits - 1)
+                f(static_cast<index_type>(w * word_bits + __builtin_ctzll(bits)));
+        }
+    }
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+template <typename F>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::for_each(F&& f)
+{
+    each_occupied([&](index_type i) { f(key_type { i, storage.slots()[i].generation }, *value_at(i)); });
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+template <typename F>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::for_each(F&& f) const
+{
+    each_occupied([&](index_type i) { f(key_type { i, storage.slots()[i].generation }, *value_at(i)); });
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+std::vector<typename DirectAddressTable<Value, Universe, Storage, Instrument>::key_type> DirectAddressTable<Value, Universe, Storage, Instrument>::compact()
+{
+    static_assert(std::is_nothrow_move_constructible_v<Value>, "compact() moves satellites and cannot undo a throwing move");
+    std::vector<key_type> renumbered(state().key, invalid_key);
+    auto slots = storage.slots();
+    index_type next = 0;
+    /// ascending order: slot `next` is either i itself or already vacant
+    each_occupied([&](index_type i) {
+        if (i != next) {
+            new (slots[next].bytes) Value(std::move(*value_at(i)));
+            value_at(i)->~Value();
+            ++slots[next].generation;
+            set(next);
+            ++slots[i].generation;
+            reset(i);
+        }
+        renumbered[i] = { next, slots[next].generation };
+        ++next;
+    });
+    /// everything past the live satellites is handed out fresh again
+    state().key = next;
+    state().free_head = direct_address::no_slot;
+    return renumbered;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::place(Entry& entry, index_type i)
+{
+    /// construct first: if it throws the slot is still vacant
+    new (storage.slots()[i].bytes) Value(entry.satellite);
+    set(i);
+    ++state().live_count;
+    entry.key = { i, ++storage.slots()[i].generation };
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::reuse_key_on(Entry& entry)
+{
+    auto i = state().free_head;
+    auto next = storage.slots()[i].next_free;
+    try {
+        place(entry, i);
+    } catch (...) {
+        /// the slot stays on the free list; the failed construction
+        /// may have overwritten the link it shares the bytes with
+        storage.slots()[i].next_free = next;
+        throw;
+    }
+    state().free_head = next;
+    this->on_free_list_hit();
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::Insert(Entry& entry)
+{
+    /// if keys have been exhausted--hand back an invalid key
+    if (state().key >= universe() && state().free_head == direct_address::no_slot) {
+        this->on_table_full();
+        entry.key = invalid_key;
+    } else if (state().key >= universe()) {
+        reuse_key_on(entry);
+    } else {
+        /// the key is only spent once the satellite is constructed
+        place(entry, static_cast<index_type>(state().key));
+        ++state().key;
+        this->on_fresh_slot();
+    }
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+void DirectAddressTable<Value, Universe, Storage, Instrument>::Delete(Entry& entry)
+{
+    /// harmless to delete an entry that is already NULL, or stale
+    if (occupied(entry.key)) {
+        auto i = entry.key.index;
+        value_at(i)->~Value();
+        reset(i);
+        --state().live_count;
+        ++storage.slots()[i].generation;
+        storage.slots()[i].next_free = state().free_head;
+        state().free_head = i;
+        entry.key = invalid_key;
+    }
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+const Value* DirectAddressTable<Value, Universe, Storage, Instrument>::Search(const Entry& entry) const
+{
+    return Search(entry.key);
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+Value* DirectAddressTable<Value, Universe, Storage, Instrument>::Search(key_type k)
+{
+    /// return valid satellite... or not
+    auto hit = occupied(k);
+    this->on_lookup(hit);
+    return hit ? value_at(k.index) : nullptr;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+const Value* DirectAddressTable<Value, Universe, Storage, Instrument>::Search(key_type k) const
+{
+    auto hit = occupied(k);
+    this->on_lookup(hit);
+    return hit ? value_at(k.index) : nullptr;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+std::size_t DirectAddressTable<Value, Universe, Storage, Instrument>::search_batch_scalar(const key_type* keys, std::size_t first, std::size_t n, Value* out, std::uint64_t* found) const
+{
+    /// far enough ahead to cover a miss to memory, near enough to stay in L1
+    constexpr std::size_t prefetch_distance = 16;
+
+    std::size_t hits = 0;
+    auto slots = storage.slots();
+    for (auto i = first; i < n; ++i) {
+        if (i + prefetch_distance < n && valid(keys[i + prefetch_distance]))
+            __builtin_prefetch(&slots[keys[i + prefetch_distance].index]);
+        if (occupied(keys[i])) {
+            out[i] = *value_at(keys[i].index);
+            found[i / direct_address::word_bits] |= std::uint64_t(1) << (i % direct_address::word_bits);
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+template <typename Value, std::size_t Universe, typename Storage, typename Instrument>
+std::size_t DirectAddressTable<Value, Universe, Storage, Instrument>::search_batch(const key_type* keys, std::size_t n, Value* out, std::uint64_t* found) const
+{
+    std::fill(found, found + direct_address::words_for(n), std::uint64_t(0));
+    std::size_t i = 0, hits = 0;
+
+#ifdef __AVX2__
+    using slot_type = direct_address::Slot<Value>;
+    /// gathers take signed 32-bit indices, scaled by at most 8 bytes
+    if constexpr (sizeof(Value) == 4 && std::is_trivially_copyable_v<Value> && sizeof(slot_type) == 8) {
+        if (universe() <= 0x7fffffff) {
+            auto base = reinterpret_cast<const int*>(storage.slots());
+            auto generations = reinterpret_cast<const int*>(reinterpret_cast<const unsigned char*>(base) + offsetof(slot_type, generation));
+
+            /// keys are {index, generation} pairs: split eight of them
+            /// into a vector of indices and a vector of generations
+            const auto split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            const auto sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+            const auto bound = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(universe())), sign);
+            const auto one = _mm256_set1_epi32(1);
+
+            for (; i + 8 <= n; i += 8) {
+                auto lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), split);
+                auto hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i + 4)), split);
+                auto index = _mm256_permute2x128_si256(lo, hi, 0x20);
+                auto generation = _mm256_permute2x128_si256(lo, hi, 0x31);
+
+                /// unsigned index < universe, and an odd (occupied) generation
+                auto in_range = _mm256_cmpgt_epi32(bound, _mm256_xor_si256(index, sign));
+                auto odd = _mm256_cmpeq_epi32(_mm256_and_si256(generation, one), one);
+                auto slot_generation = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), generations, index, in_range, 8);
+                auto live = _mm256_and_si256(_mm256_and_si256(in_range, odd), _mm256_cmpeq_epi32(slot_generation, generation));
+
+                auto dst = reinterpret_cast<__m256i*>(out + i);
+                auto values = _mm256_mask_i32gather_epi32(_mm256_loadu_si256(dst), base, index, live, 8);
+                _mm256_storeu_si256(dst, values);
+
+                auto mask = static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(live)));
+                found[i / direct_address::word_bits] |= mask << (i % direct_address::word_bits);
+                hits += __builtin_popcountll(mask);
+            }
+        }
+    }
+#endif
+
+    hits += search_batch_scalar(keys, i, n, out, found);
+    this->on_lookups(n, hits);
+    return hits;
+}
+
+#endif //DIRECTADDRESSTABLE_DIRECTADDRESSTABLE_H
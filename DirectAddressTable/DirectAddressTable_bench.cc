@@ -0,0 +1,162 @@
+/// DirectAddressTable vs std::unordered_map with dense integer keys,
+/// and DirectAddressTable::search_batch vs a Search() per key.
+///
+/// usage: DirectAddressTable_bench [rounds]
+/// g++ -std=c++17 -O2 -march=native DirectAddressTable_bench.cc
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DirectAddressTable.hpp"
+
+constexpr std::size_t slots = std::size_t(1) << 20;
+
+template <typename F>
+double ns_per_op(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / slots;
+}
+
+void report(const char* name, double insert, double search, double remove, long long checksum)
+{
+    std::cout << name << ": insert " << insert << " ns/op, search " << search
+              << " ns/op, delete " << remove << " ns/op  (checksum " << checksum << ")\n";
+}
+
+template <typename Table>
+void bench_table(const char* name, Table& table, const std::vector<std::uint32_t>& order)
+{
+    std::vector<typename Table::Entry> entries(slots);
+    long long checksum = 0;
+    auto insert = ns_per_op([&] {
+        for (std::size_t i = 0; i < slots; ++i) {
+            entries[i].satellite = static_cast<int>(i);
+            table.Insert(entries[i]);
+        }
+    });
+    auto search = ns_per_op([&] {
+        for (auto i : order)
+            checksum += *table.Search(entries[i]);
+    });
+    auto remove = ns_per_op([&] {
+        for (auto i : order)
+            table.Delete(entries[i]);
+    });
+    report(name, insert, search, remove, checksum);
+}
+
+void bench_unordered_map(const std::vector<std::uint32_t>& order)
+{
+    std::unordered_map<std::uint32_t, int> table;
+    table.reserve(slots);
+    long long checksum = 0;
+    auto insert = ns_per_op([&] {
+        for (std::size_t i = 0; i < slots; ++i)
+            table.emplace(static_cast<std::uint32_t>(i), static_cast<int>(i));
+    });
+    auto search = ns_per_op([&] {
+        for (auto i : order)
+            checksum += table.find(i)->second;
+    });
+    auto remove = ns_per_op([&] {
+        for (auto i : order)
+            table.erase(i);
+    });
+    report("std::unordered_map", insert, search, remove, checksum);
+}
+
+/// 32 bytes of payload: too wide to gather, so search_batch prefetches
+struct Wide {
+    long long a, b, c, d;
+};
+
+int payload(int i) { return i; }
+long long payload_sum(int v) { return v; }
+Wide wide_payload(int i) { return { i, i, i, i }; }
+long long payload_sum(const Wide& w) { return w.a; }
+
+template <typename Value, typename Make>
+void bench_batch(const char* name, const std::vector<std::uint32_t>& order, Make make)
+{
+    DirectAddressTable<Value> table(slots);
+    std::vector<typename DirectAddressTable<Value>::Entry> entries(slots);
+    for (std::size_t i = 0; i < slots; ++i) {
+        entries[i].satellite = make(static_cast<int>(i));
+        table.Insert(entries[i]);
+    }
+    /// every eighth key is deleted, so lookups also miss
+    for (std::size_t i = 0; i < slots; i += 8) {
+        auto stale = entries[i];
+        table.Delete(entries[i]);
+        entries[i] = stale;
+    }
+
+    std::vector<direct_address::Key> sequential(slots), random(slots);
+    for (std::size_t i = 0; i < slots; ++i) {
+        sequential[i] = entries[i].key;
+        random[i] = entries[order[i]].key;
+    }
+
+    std::vector<Value> out(slots);
+    std::vector<std::uint64_t> found(direct_address::words_for(slots));
+    for (auto pattern : { &sequential, &random }) {
+        auto& keys = *pattern;
+        long long loop_sum = 0, batch_sum = 0;
+        std::size_t hits = 0;
+        /// what callers write today: one Search() per key
+        auto loop = ns_per_op([&] {
+            for (std::size_t i = 0; i < slots; ++i)
+                if (auto v = table.Search(keys[i]))
+                    out[i] = *v;
+        });
+        for (std::size_t i = 0; i < slots; ++i)
+            if (table.Search(keys[i]))
+                loop_sum += payload_sum(out[i]);
+        auto batch = ns_per_op([&] {
+            hits = table.search_batch(keys.data(), keys.size(), out.data(), found.data());
+        });
+        for (std::size_t i = 0; i < slots; ++i)
+            if (found[i / 64] >> (i % 64) & 1)
+                batch_sum += payload_sum(out[i]);
+        std::cout << name << (pattern == &sequential ? " sequential" : " random")
+                  << ": Search loop " << loop << " ns/key, search_batch " << batch
+                  << " ns/key  (" << hits << " hits, checksums " << loop_sum
+                  << (loop_sum == batch_sum ? " == " : " != ") << batch_sum << ")\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int rounds = argc > 1 ? std::stoi(argv[1]) : 3;
+
+    std::vector<std::uint32_t> order(slots);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    std::cout << slots << " dense keys, random lookup/delete order\n";
+    for (int round = 0; round < rounds; ++round) {
+        auto fixed = std::make_unique<DirectAddressTable<int, slots>>();
+        bench_table("DirectAddressTable<int, 2^20>", *fixed, order);
+        DirectAddressTable<int> dynamic(slots);
+        bench_table("DirectAddressTable<int>(2^20)", dynamic, order);
+        bench_unordered_map(order);
+    }
+
+    std::cout << "\nbatched lookups, 1 in 8 keys stale\n";
+    for (int round = 0; round < rounds; ++round) {
+        bench_batch<int>("int", order, payload);
+        bench_batch<Wide>("32-byte", order, wide_payload);
+    }
+    return 0;
+}
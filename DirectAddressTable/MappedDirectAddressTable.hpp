@@ -0,0 +1,313 @@
+/**
+ * -------- Mapped Direct Address Table -------------
+ * A DirectAddressTable whose slots, occupancy bitmaps
+ * and free-slot state live in one memory-mapped image,
+ * so a restarted process can pick the table back up
+ * instead of replaying every Insert().
+ *
+ * open()     - O(1): validate the header, map the file;
+ *              pages fault in on first touch
+ * snapshot() - fork a writer and return; the caller pays for
+ *              fork() copying the page tables, in proportion
+ *              to the mapping's size, not for any writing
+ *
+ * The file is
+ *
+ *     [FileHeader][slots][occupancy bitmap and summaries]
+ *
+ * with the header padded to a cache line. FileHeader::version
+ * changes whenever that layout does; open() refuses files of
+ * another version, value size or slot size.
+ *
+ * The table is mapped MAP_PRIVATE: changes stay in this
+ * process until snapshot(). snapshot() forks; the child sees
+ * a copy-on-write freeze of the table as of the fork and
+ * writes it to "<path>.tmp" with the header's committed mark
+ * last, fsyncs, and renames it over <path>. A writer killed
+ * at any point leaves the previous snapshot in place.
+ *
+ * POSIX only. Value must be trivially copyable, since its
+ * bytes are the file format.
+ */
+
+#ifndef DIRECTADDRESSTABLE_MAPPEDDIRECTADDRESSTABLE_H
+#define DIRECTADDRESSTABLE_MAPPEDDIRECTADDRESSTABLE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "DirectAddressTable.hpp"
+
+namespace direct_address {
+
+struct FileHeader {
+    static constexpr char expected_magic[8] = { 'D', 'A', 'T', 'A', 'B', 'L', 'E', '\0' };
+    static constexpr std::uint32_t current_version = 1;
+    /// written last by a snapshot writer; anything else is a torn file
+    static constexpr std::uint64_t committed_mark = 0x434f4d4d49545445; // "COMMITTE"
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_bytes;
+    std::uint64_t value_size;
+    std::uint64_t slot_size;
+    std::uint64_t universe;
+    std::uint64_t file_bytes;
+    TableState state;
+    std::uint64_t committed;
+};
+
+inline std::system_error os_error(const std::string& what)
+{
+    return std::system_error(errno, std::generic_category(), "MappedDirectAddressTable: " + what);
+}
+
+/// slots, bitmaps and state inside one private file (or anonymous) mapping
+template <typename Value>
+struct MappedStorage {
+    static_assert(std::is_trivially_copyable_v<Value>, "a mapped satellite's bytes are the file format");
+
+    static constexpr std::size_t header_bytes = (sizeof(FileHeader) + 63) & ~std::size_t(63);
+
+    static std::size_t bytes_for(std::size_t universe)
+    {
+        auto bitmap_offset = (header_bytes + universe * sizeof(Slot<Value>) + 7) & ~std::size_t(7);
+        return bitmap_offset + bitmap_words_for(universe) * sizeof(std::uint64_t);
+    }
+
+    /// a new, empty table not yet backed by any file
+    MappedStorage(std::string path, std::size_t universe)
+        : path(std::move(path))
+        , length(bytes_for(universe))
+    {
+        if (universe > max_universe)
+            throw std::length_error("MappedDirectAddressTable: universe does not fit a 32-bit index");
+        map(-1);
+        auto& h = header();
+        std::memcpy(h.magic, FileHeader::expected_magic, sizeof(h.magic));
+        h.version = FileHeader::current_version;
+        h.header_bytes = header_bytes;
+        h.value_size = sizeof(Value);
+        h.slot_size = sizeof(Slot<Value>);
+        h.universe = universe;
+        h.file_bytes = length;
+        h.state = {};
+        h.committed = 0;
+    }
+
+    /// the last committed snapshot at path
+    explicit MappedStorage(std::string path)
+        : path(std::move(path))
+    {
+        auto fd = ::open(this->path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw os_error("cannot open " + this->path);
+
+        FileHeader h;
+        struct stat st;
+        auto ok = ::pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) && ::fstat(fd, &st) == 0;
+        auto problem = !ok ? "truncated header"
+            : std::memcmp(h.magic, FileHeader::expected_magic, sizeof(h.magic)) != 0 ? "not a table snapshot"
+            : h.version != FileHeader::current_version ? "unsupported version"
+            : h.header_bytes != header_bytes || h.value_size != sizeof(Value) || h.slot_size != sizeof(Slot<Value>) ? "layout does not match Value"
+            : h.universe > max_universe || h.file_bytes != bytes_for(h.universe) || static_cast<std::uint64_t>(st.st_size) != h.file_bytes ? "size does not match header"
+            : h.state.key > h.universe || h.state.live_count > h.state.key
+                || (h.state.free_head != no_slot && h.state.free_head >= h.state.key) ? "table state does not match header"
+            : h.committed != FileHeader::committed_mark ? "snapshot was never committed"
+            : nullptr;
+        if (problem) {
+            ::close(fd);
+            throw std::runtime_error("MappedDirectAddressTable: " + this->path + ": " + problem);
+        }
+
+        length = h.file_bytes;
+        map(fd);
+        ::close(fd);
+    }
+
+    MappedStorage(const MappedStorage&) = delete;
+    MappedStorage& operator=(const MappedStorage&) = delete;
+    MappedStorage(MappedStorage&& rhs) noexcept
+        : path(std::move(rhs.path))
+        , base(std::exchange(rhs.base, nullptr))
+        , length(std::exchange(rhs.length, 0))
+        , writer(std::exchange(rhs.writer, -1))
+    {
+    }
+    MappedStorage& operator=(MappedStorage&& rhs) noexcept
+    {
+        std::swap(path, rhs.path);
+        std::swap(base, rhs.base);
+        std::swap(length, rhs.length);
+        std::swap(writer, rhs.writer);
+        return *this;
+    }
+    ~MappedStorage()
+    {
+        if (base)
+            ::munmap(base, length);
+    }
+
+    FileHeader& header() { return *reinterpret_cast<FileHeader*>(base); }
+    const FileHeader& header() const { return *reinterpret_cast<const FileHeader*>(base); }
+
+    std::size_t universe() const { return base ? header().universe : 0; }
+    Slot<Value>* slots() { return reinterpret_cast<Slot<Value>*>(base + header_bytes); }
+    const Slot<Value>* slots() const { return reinterpret_cast<const Slot<Value>*>(base + header_bytes); }
+    std::uint64_t* occupancy() { return reinterpret_cast<std::uint64_t*>(base + length) - bitmap_words_for(universe()); }
+    const std::uint64_t* occupancy() const { return reinterpret_cast<const std::uint64_t*>(base + length) - bitmap_words_for(universe()); }
+    TableState& state() { return header().state; }
+    const TableState& state() const { return header().state; }
+
+    void map(int fd)
+    {
+        auto flags = fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_PRIVATE;
+        auto p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (p == MAP_FAILED)
+            throw os_error("cannot map " + path);
+        base = static_cast<unsigned char*>(p);
+    }
+
+    /// in the forked child: write the frozen image, then commit it
+    [[noreturn]] static void write_image(unsigned char* image, std::size_t length, const char* tmp, const char* path, const char* dir)
+    {
+        auto fd = ::open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            ::_exit(1);
+        auto write_all = [fd](const unsigned char* p, std::size_t n, off_t at) {
+            while (n > 0) {
+                auto written = ::pwrite(fd, p, n, at);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return false;
+                p += written;
+                n -= written;
+                at += written;
+            }
+            return true;
+        };
+        /// body first, header with the committed mark last; the image is
+        /// this process's private copy, so stamping it is free
+        reinterpret_cast<FileHeader*>(image)->committed = FileHeader::committed_mark;
+        if (!write_all(image + header_bytes, length - header_bytes, header_bytes)
+            || ::fdatasync(fd) != 0
+            || !write_all(image, header_bytes, 0)
+            || ::fsync(fd) != 0
+            || ::close(fd) != 0
+            || ::rename(tmp, path) != 0)
+            ::_exit(1);
+
+        /// make the rename itself durable
+        auto dir_fd = ::open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd >= 0) {
+            ::fsync(dir_fd);
+            ::close(dir_fd);
+        }
+        ::_exit(0);
+    }
+
+    std::string path;
+    unsigned char* base = nullptr;
+    std::size_t length = 0;
+    /// pid of the snapshot writer still running, or -1
+    pid_t writer = -1;
+};
+
+} // namespace direct_address
+
+template <typename Value, typename Instrument = NoInstrumentation>
+class MappedDirectAddressTable
+    : public DirectAddressTable<Value, dynamic_universe, direct_address::MappedStorage<Value>, Instrument> {
+    using table = DirectAddressTable<Value, dynamic_universe, direct_address::MappedStorage<Value>, Instrument>;
+
+public:
+    /// a new, empty table; nothing is written to path until snapshot()
+    static MappedDirectAddressTable create(const std::string& path, std::size_t universe)
+    {
+        return MappedDirectAddressTable(direct_address::MappedStorage<Value>(path, universe));
+    }
+    /// the table as of the last committed snapshot at path
+    static MappedDirectAddressTable open(const std::string& path)
+    {
+        return MappedDirectAddressTable(direct_address::MappedStorage<Value>(path));
+    }
+
+    MappedDirectAddressTable(MappedDirectAddressTable&&) noexcept = default;
+    /// waits for this table's snapshot writer, if any, then takes rhs's
+    MappedDirectAddressTable& operator=(MappedDirectAddressTable&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            wait_snapshot();
+            table::operator=(std::move(rhs));
+        }
+        return *this;
+    }
+    /// waits for a snapshot still being written, so no writer is left unreaped
+    ~MappedDirectAddressTable() { wait_snapshot(); }
+
+    /// start writing the table as it is now to path; returns the writer's
+    /// pid once fork() has copied the page tables, which takes time in
+    /// proportion to the mapping's size. Only one snapshot is in flight
+    /// at a time: this waits for the previous one first.
+    pid_t snapshot();
+    /// wait for the writer started by snapshot(); true if it committed
+    bool wait_snapshot();
+
+    const std::string& path() const { return this->storage.path; }
+
+private:
+    explicit MappedDirectAddressTable(direct_address::MappedStorage<Value>&& s)
+        : table(std::move(s))
+    {
+    }
+};
+
+template <typename Value, typename Instrument>
+pid_t MappedDirectAddressTable<Value, Instrument>::snapshot()
+{
+    wait_snapshot();
+
+    auto& storage = this->storage;
+    /// everything the child needs is computed before fork: after it,
+    /// a multi-threaded parent's child may not allocate
+    auto tmp = storage.path + ".tmp";
+    auto slash = storage.path.find_last_of('/');
+    auto dir = slash == std::string::npos ? std::string(".") : storage.path.substr(0, slash + 1);
+
+    auto pid = ::fork();
+    if (pid < 0)
+        throw direct_address::os_error("cannot fork snapshot writer");
+    if (pid == 0)
+        direct_address::MappedStorage<Value>::write_image(storage.base, storage.length, tmp.c_str(), storage.path.c_str(), dir.c_str());
+
+    storage.writer = pid;
+    return pid;
+}
+
+template <typename Value, typename Instrument>
+bool MappedDirectAddressTable<Value, Instrument>::wait_snapshot()
+{
+    auto& writer = this->storage.writer;
+    if (writer < 0)
+        return true;
+    int status = 0;
+    while (::waitpid(writer, &status, 0) < 0 && errno == EINTR)
+        ;
+    writer = -1;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#endif //DIRECTADDRESSTABLE_MAPPEDDIRECTADDRESSTABLE_H
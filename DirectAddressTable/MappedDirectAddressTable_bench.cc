@@ -0,0 +1,181 @@
+/// Restart time of a MappedDirectAddressTable: open() of a snapshot vs
+/// rebuilding the table by replaying every Insert(), plus how long
+/// snapshot() holds up the caller and how long the writer takes.
+///
+/// usage: MappedDirectAddressTable_bench [--crash] [keys] [dir]
+/// g++ -std=c++17 -O2 MappedDirectAddressTable_bench.cc   (POSIX: fork, mmap)
+///
+/// --crash skips the timings. It commits a snapshot of state A, mutates
+/// the table to state B, then starts snapshots and SIGKILLs the writer
+/// after a range of delays. Every reopen must yield exactly A or exactly
+/// B (and B once a writer is let finish), never a mix or a torn file.
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedDirectAddressTable.hpp"
+
+struct Record {
+    std::uint64_t id;
+    std::uint64_t check;
+};
+
+Record make_record(std::uint64_t id, std::uint64_t round) { return { id, id * 0x9e3779b97f4a7c15 ^ round }; }
+
+using Table = MappedDirectAddressTable<Record>;
+using Entry = Table::Entry;
+
+template <typename F>
+double ms(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/// the table's full contents as (key, record) pairs in index order
+std::vector<std::pair<direct_address::Key, Record>> contents(const Table& table)
+{
+    std::vector<std::pair<direct_address::Key, Record>> out;
+    table.for_each([&](direct_address::Key k, const Record& r) { out.emplace_back(k, r); });
+    return out;
+}
+
+bool same(const std::vector<std::pair<direct_address::Key, Record>>& a,
+    const std::vector<std::pair<direct_address::Key, Record>>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (a[i].first != b[i].first || a[i].second.id != b[i].second.id || a[i].second.check != b[i].second.check)
+            return false;
+    return true;
+}
+
+void bench(std::size_t keys, const std::string& path)
+{
+    double build = 0, snapshot_call = 0, snapshot_total = 0;
+    {
+        auto table = Table::create(path, keys);
+        std::vector<Entry> entries(keys);
+        build = ms([&] {
+            for (std::size_t i = 0; i < keys; ++i) {
+                entries[i].satellite = make_record(i, 0);
+                table.Insert(entries[i]);
+            }
+        });
+        snapshot_total = ms([&] {
+            snapshot_call = ms([&] { table.snapshot(); });
+            if (!table.wait_snapshot())
+                throw std::runtime_error("snapshot writer failed");
+        });
+    }
+
+    /// restart: map the snapshot, then touch it all (a full scan) so
+    /// the page-in cost is counted too
+    double open = 0, scan = 0;
+    std::uint64_t checksum = 0;
+    {
+        open = ms([&] {
+            auto table = Table::open(path);
+            scan = ms([&] { table.for_each([&](direct_address::Key, const Record& r) { checksum += r.check; }); });
+        });
+        open -= scan;
+    }
+
+    std::cout << keys << " keys (" << keys * sizeof(direct_address::Slot<Record>) / (1024.0 * 1024.0) << " MiB of slots)\n"
+              << "  replay " << keys << " Insert()s: " << build << " ms\n"
+              << "  open(): " << open << " ms, then a full scan " << scan << " ms  (checksum " << checksum << ")\n"
+              << "  snapshot(): " << snapshot_call << " ms in the caller, " << snapshot_total << " ms until committed\n";
+    std::remove(path.c_str());
+}
+
+int crash(std::size_t keys, const std::string& path)
+{
+    std::size_t failures = 0;
+    auto table = Table::create(path, keys);
+    std::vector<Entry> entries(keys);
+    for (std::size_t i = 0; i < keys; ++i) {
+        entries[i].satellite = make_record(i, 0);
+        table.Insert(entries[i]);
+    }
+    table.snapshot();
+    if (!table.wait_snapshot())
+        ++failures;
+    auto a = contents(table);
+
+    /// state B: delete every third record, rewrite the rest, reuse slots
+    for (std::size_t i = 0; i < keys; ++i) {
+        if (i % 3 == 0) {
+            table.Delete(entries[i]);
+            continue;
+        }
+        table.Search(entries[i].key)->check ^= 1;
+    }
+    for (std::size_t i = 0; i < keys; i += 6) {
+        entries[i].satellite = make_record(i, 1);
+        table.Insert(entries[i]);
+    }
+    auto b = contents(table);
+
+    std::size_t saw_a = 0, saw_b = 0;
+    for (auto delay_us : { 0, 10, 100, 300, 1000, 3000, 10000, 30000, 100000 }) {
+        auto pid = table.snapshot();
+        std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+        ::kill(pid, SIGKILL);
+        table.wait_snapshot();
+
+        auto reopened = contents(Table::open(path));
+        if (same(reopened, a))
+            ++saw_a;
+        else if (same(reopened, b))
+            ++saw_b;
+        else
+            ++failures;
+    }
+
+    /// a writer allowed to finish commits B, and the reopened table
+    /// carries on with B's free list
+    table.snapshot();
+    if (!table.wait_snapshot())
+        ++failures;
+    auto reopened = Table::open(path);
+    if (!same(contents(reopened), b))
+        ++failures;
+    Entry extra;
+    extra.satellite = make_record(keys, 2);
+    reopened.Insert(extra);
+    if (extra.key == Table::invalid_key || extra.key.index % 3 != 0 || reopened.size() != b.size() + 1)
+        ++failures;
+
+    std::cout << "crash: " << keys << " keys, killed writers left A " << saw_a << " times, B "
+              << saw_b << " times; " << failures << " failures\n";
+    std::remove(path.c_str());
+    std::remove((path + ".tmp").c_str());
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    int arg = 1;
+    bool crash_mode = argc > 1 && std::string(argv[1]) == "--crash";
+    if (crash_mode)
+        ++arg;
+    std::size_t keys = argc > arg ? std::stoull(argv[arg]) : std::size_t(1) << 22;
+    std::string dir = argc > arg + 1 ? argv[arg + 1] : ".";
+    auto path = dir + "/MappedDirectAddressTable_bench." + std::to_string(::getpid()) + ".dat";
+
+    if (crash_mode)
+        return crash(keys, path);
+    bench(keys, path);
+    return 0;
+}
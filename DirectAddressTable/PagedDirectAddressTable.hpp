@@ -0,0 +1,228 @@
+/**
+ * --------- Paged Direct Address Table -------------
+ * Direct addressing over the full 32-bit key space,
+ * for keys that are dense locally but sparse globally.
+ *
+ * A key splits into a page number and an offset. The
+ * directory maps page numbers to pages; a page holds
+ * slots_per_page satellites plus their occupancy bits
+ * in one PageBytes block (4 KiB by default, 2 MiB for
+ * huge pages). Pages are allocated on the first Insert()
+ * into them and released by the Delete() that empties
+ * them.
+ *
+ * Delete() - Worst Case - O(1)
+ * Insert() - Worst Case - O(1)
+ * Search() - Worst Case - O(1), two dependent loads:
+ *            directory[page], then page->slots[offset]
+ *
+ * Unlike DirectAddressTable the caller chooses the keys,
+ * and Insert() overwrites, as in CLRS DIRECT-ADDRESS-INSERT.
+ *
+ * The directory is calloc'ed, so the kernel only backs
+ * the parts of it that hold a page pointer.
+ */
+
+#ifndef DIRECTADDRESSTABLE_PAGEDDIRECTADDRESSTABLE_H
+#define DIRECTADDRESSTABLE_PAGEDDIRECTADDRESSTABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+template <typename Value, std::size_t PageBytes = 4096>
+class PagedDirectAddressTable {
+public:
+    using key_type = std::uint32_t;
+
+    /// occupancy words, live count and slots must all fit one block
+    static constexpr std::size_t slots_per_page
+        = 8 * (PageBytes - 2 * sizeof(std::uint64_t)) / (8 * sizeof(Value) + 1);
+    static constexpr std::size_t page_count = ((std::size_t(1) << 32) + slots_per_page - 1) / slots_per_page;
+    static_assert(slots_per_page > 0, "a page must hold at least one satellite");
+
+    PagedDirectAddressTable();
+    PagedDirectAddressTable(const PagedDirectAddressTable&) = delete;
+    PagedDirectAddressTable& operator=(const PagedDirectAddressTable&) = delete;
+    /// move constructor: rhs keeps no directory and may only be
+    /// destroyed or assigned to
+    PagedDirectAddressTable(PagedDirectAddressTable&&) noexcept;
+    /// move assignment: rhs is left a valid, empty table
+    PagedDirectAddressTable& operator=(PagedDirectAddressTable&&) noexcept;
+    /// release every page
+    ~PagedDirectAddressTable() { clear(); }
+
+    /// store value under k; true if k was empty, false if it was overwritten
+    bool Insert(key_type k, const Value& value);
+    /// false if k was already empty
+    bool Delete(key_type k);
+    Value* Search(key_type k);
+    const Value* Search(key_type k) const;
+
+    std::size_t size() const { return live; }
+    /// pages currently allocated
+    std::size_t pages() const { return page_total; }
+    /// bytes of pages plus the directory entries they occupy
+    std::size_t resident_bytes() const { return page_total * (PageBytes + sizeof(Page*)); }
+    void clear();
+
+private:
+    static constexpr std::size_t words_per_page = (slots_per_page + 63) / 64;
+
+    struct Page {
+        std::uint64_t occupancy[words_per_page];
+        std::uint64_t live;
+        struct Slot {
+            alignas(Value) unsigned char bytes[sizeof(Value)];
+        } slots[slots_per_page];
+
+        Value* value(std::size_t offset) { return std::launder(reinterpret_cast<Value*>(slots[offset].bytes)); }
+        bool test(std::size_t offset) const { return (occupancy[offset / 64] >> (offset % 64)) & 1; }
+    };
+    static_assert(sizeof(Page) <= PageBytes, "page header and slots overflow the block");
+
+    /// 2 MiB pages are aligned so they can land on huge pages; smaller
+    /// ones only to a cache line (or Value's alignment, if stricter),
+    /// since over-aligning a 4 KiB request makes malloc spend a second
+    /// OS page on padding
+    static constexpr std::size_t huge_page = 2 * 1024 * 1024;
+    static constexpr std::size_t page_alignment = PageBytes >= huge_page
+        ? std::max<std::size_t>(huge_page, alignof(Page))
+        : std::max<std::size_t>(64, alignof(Page));
+
+    static std::size_t page_of(key_type k) { return k / slots_per_page; }
+    static std::size_t offset_of(key_type k) { return k % slots_per_page; }
+
+    struct FreeDirectory {
+        void operator()(Page** directory) const { std::free(directory); }
+    };
+
+    std::unique_ptr<Page*[], FreeDirectory> directory;
+    std::size_t live = 0;
+    std::size_t page_total = 0;
+};
+
+template <typename Value, std::size_t PageBytes>
+PagedDirectAddressTable<Value, PageBytes>::PagedDirectAddressTable()
+    : directory(static_cast<Page**>(std::calloc(page_count, sizeof(Page*))))
+{
+    if (!directory)
+        throw std::bad_alloc();
+}
+
+template <typename Value, std::size_t PageBytes>
+PagedDirectAddressTable<Value, PageBytes>::PagedDirectAddressTable(PagedDirectAddressTable&& rhs) noexcept
+    : directory(std::move(rhs.directory))
+    , live(std::exchange(rhs.live, 0))
+    , page_total(std::exchange(rhs.page_total, 0))
+{
+}
+
+template <typename Value, std::size_t PageBytes>
+PagedDirectAddressTable<Value, PageBytes>& PagedDirectAddressTable<Value, PageBytes>::operator=(PagedDirectAddressTable&& rhs) noexcept
+{
+    /// adjust for possible self assignment
+    if (this != &rhs) {
+        /// rhs takes this table's emptied directory
+        clear();
+        std::swap(directory, rhs.directory);
+        live = std::exchange(rhs.live, 0);
+        page_total = std::exchange(rhs.page_total, 0);
+    }
+    return *this;
+}
+
+template <typename Value, std::size_t PageBytes>
+bool PagedDirectAddressTable<Value, PageBytes>::Insert(key_type k, const Value& value)
+{
+    auto& page = directory[page_of(k)];
+    if (!page) {
+        /// first satellite on this page: allocate it, all slots empty
+        page = static_cast<Page*>(::operator new(PageBytes, std::align_val_t(page_alignment)));
+        std::fill(page->occupancy, page->occupancy + words_per_page, std::uint64_t(0));
+        page->live = 0;
+        ++page_total;
+    }
+
+    auto offset = offset_of(k);
+    if (page->test(offset)) {
+        *page->value(offset) = value;
+        return false;
+    }
+    try {
+        new (page->slots[offset].bytes) Value(value);
+    } catch (...) {
+        /// only a page allocated above is empty here: do not keep it
+        if (page->live == 0) {
+            ::operator delete(page, std::align_val_t(page_alignment));
+            page = nullptr;
+            --page_total;
+        }
+        throw;
+    }
+    page->occupancy[offset / 64] |= std::uint64_t(1) << (offset % 64);
+    ++page->live;
+    ++live;
+    return true;
+}
+
+template <typename Value, std::size_t PageBytes>
+bool PagedDirectAddressTable<Value, PageBytes>::Delete(key_type k)
+{
+    auto& page = directory[page_of(k)];
+    auto offset = offset_of(k);
+    /// harmless to delete a key that is already empty
+    if (!page || !page->test(offset))
+        return false;
+
+    page->value(offset)->~Value();
+    page->occupancy[offset / 64] &= ~(std::uint64_t(1) << (offset % 64));
+    --live;
+    if (--page->live == 0) {
+        /// last satellite gone: hand the page back
+        ::operator delete(page, std::align_val_t(page_alignment));
+        page = nullptr;
+        --page_total;
+    }
+    return true;
+}
+
+template <typename Value, std::size_t PageBytes>
+Value* PagedDirectAddressTable<Value, PageBytes>::Search(key_type k)
+{
+    auto page = directory[page_of(k)];
+    auto offset = offset_of(k);
+    return page && page->test(offset) ? page->value(offset) : nullptr;
+}
+
+template <typename Value, std::size_t PageBytes>
+const Value* PagedDirectAddressTable<Value, PageBytes>::Search(key_type k) const
+{
+    return const_cast<PagedDirectAddressTable*>(this)->Search(k);
+}
+
+template <typename Value, std::size_t PageBytes>
+void PagedDirectAddressTable<Value, PageBytes>::clear()
+{
+    /// a moved-from table has no directory
+    if (!directory)
+        return;
+    for (std::size_t p = 0; page_total > 0 && p < page_count; ++p) {
+        auto& page = directory[p];
+        if (!page)
+            continue;
+        for (std::size_t w = 0; w < words_per_page; ++w)
+            for (auto bits = page->occupancy[w]; bits; bits &= bits - 1)
+                page->value(w * 64 + __builtin_ctzll(bits))->~Value();
+        ::operator delete(page, std::align_val_t(page_alignment));
+        page = nullptr;
+        --page_total;
+    }
+    live = 0;
+}
+
+#endif //DIRECTADDRESSTABLE_PAGEDDIRECTADDRESSTABLE_H
@@ -0,0 +1,133 @@
+/// PagedDirectAddressTable vs a flat 2^32-slot array and std::unordered_map:
+/// resident memory and random lookup latency as keys get sparser.
+///
+/// Keys come in blocks of 4096 consecutive IDs scattered over the 32-bit
+/// space; density is the fraction of IDs in each block that are live.
+///
+/// usage: PagedDirectAddressTable_bench [keys]
+/// g++ -std=c++17 -O2 PagedDirectAddressTable_bench.cc   (Linux/glibc: mmap, /proc, malloc_trim)
+
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "PagedDirectAddressTable.hpp"
+
+constexpr std::size_t block_span = 4096;
+
+/// resident set size of this process in bytes
+std::size_t resident()
+{
+    std::size_t pages = 0, rss = 0;
+    std::ifstream("/proc/self/statm") >> pages >> rss;
+    return rss * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/// the flat table: every 32-bit key has a slot and an occupancy bit;
+/// mapped lazily so only touched pages become resident
+struct FlatTable {
+    static constexpr std::size_t universe = std::size_t(1) << 32;
+
+    FlatTable()
+    {
+        auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+        values = static_cast<int*>(mmap(nullptr, universe * sizeof(int), PROT_READ | PROT_WRITE, flags, -1, 0));
+        bits = static_cast<std::uint64_t*>(mmap(nullptr, universe / 8, PROT_READ | PROT_WRITE, flags, -1, 0));
+        if (values == MAP_FAILED || bits == MAP_FAILED)
+            throw std::bad_alloc();
+    }
+    ~FlatTable()
+    {
+        munmap(values, universe * sizeof(int));
+        munmap(bits, universe / 8);
+    }
+    void Insert(std::uint32_t k, int v)
+    {
+        values[k] = v;
+        bits[k / 64] |= std::uint64_t(1) << (k % 64);
+    }
+    const int* Search(std::uint32_t k) const { return (bits[k / 64] >> (k % 64)) & 1 ? &values[k] : nullptr; }
+
+    int* values;
+    std::uint64_t* bits;
+};
+
+template <typename F>
+double ns_per_key(std::size_t keys, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / keys;
+}
+
+template <typename Table, typename Lookup>
+void measure(const char* name, const std::vector<std::uint32_t>& keys, const std::vector<std::uint32_t>& probes, Lookup lookup)
+{
+    /// hand memory freed by the previous table back to the kernel
+    /// so it is not silently reused and left out of this one's count
+    malloc_trim(0);
+    auto before = resident();
+    {
+        Table table;
+        for (auto k : keys)
+            table.Insert(k, static_cast<int>(k));
+        auto bytes = resident() - before;
+
+        long long checksum = 0;
+        auto latency = ns_per_key(probes.size(), [&] {
+            for (auto k : probes)
+                checksum += lookup(table, k);
+        });
+        std::cout << "  " << name << ": " << bytes / (1024.0 * 1024.0) << " MiB resident, "
+                  << latency << " ns/lookup  (checksum " << checksum << ")\n";
+    }
+}
+
+struct UnorderedMap : std::unordered_map<std::uint32_t, int> {
+    void Insert(std::uint32_t k, int v) { emplace(k, v); }
+};
+
+int main(int argc, char* argv[])
+{
+    std::size_t total = argc > 1 ? std::stoull(argv[1]) : std::size_t(1) << 20;
+    std::mt19937 rng(42);
+
+    for (auto density : { 1.0, 0.25, 0.05, 0.01 }) {
+        auto stride = static_cast<std::size_t>(1 / density);
+        auto per_block = block_span / stride;
+        auto blocks = (total + per_block - 1) / per_block;
+
+        /// distinct blocks at random block-aligned positions
+        std::unordered_set<std::uint32_t> starts;
+        while (starts.size() < blocks)
+            starts.insert(static_cast<std::uint32_t>(rng() / block_span * block_span));
+
+        std::vector<std::uint32_t> keys;
+        for (auto start : starts)
+            for (std::size_t i = 0; i < block_span && keys.size() < total; i += stride)
+                keys.push_back(start + static_cast<std::uint32_t>(i));
+        auto probes = keys;
+        std::shuffle(probes.begin(), probes.end(), rng);
+
+        std::cout << keys.size() << " keys, density " << density << " (" << blocks << " blocks)\n";
+        auto paged = [](const auto& t, std::uint32_t k) { return *t.Search(k); };
+        measure<PagedDirectAddressTable<int>>("paged 4 KiB", keys, probes, paged);
+        measure<PagedDirectAddressTable<int, 2 * 1024 * 1024>>("paged 2 MiB", keys, probes, paged);
+        measure<FlatTable>("flat 2^32", keys, probes, paged);
+        measure<UnorderedMap>("std::unordered_map", keys, probes,
+            [](const UnorderedMap& t, std::uint32_t k) { return t.find(k)->second; });
+    }
+    return 0;
+}
@@ -0,0 +1,335 @@
+/**
+ * ------------------ Flat Map ----------------------
+ * An ordered map for small-to-medium, read-mostly data:
+ * keys and values sit in two SmallVectors instead of a
+ * node per entry, so a lookup touches only keys until
+ * it has found its match.
+ *
+ * Two layouts:
+ *
+ * sorted    - keys in ascending order, binary search.
+ *             insert() and erase() shift the tail: O(n).
+ * eytzinger - freeze() permutes keys (and values alongside)
+ *             into breadth-first order of the implicit
+ *             binary search tree, with the same index math
+ *             as the heaps: left(i) = 2i + 1, right(i) = 2i + 2.
+ *             The top of the tree shares a few cache lines,
+ *             and the search is branchless: it prefetches the
+ *             descendants a cache line's worth of levels down
+ *             while comparing. Read-only until thaw().
+ *
+ * find()   - O(log n) in either layout
+ * freeze() - O(n), thaw() - O(n)
+ *
+ * The bulk constructor sorts unsorted (key, value) pairs
+ * once; as with std::map, the first of equal keys wins.
+ */
+
+#ifndef FLATMAP_FLATMAP_H
+#define FLATMAP_FLATMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Heap/heap_index.hpp"
+#include "SmallVector.hpp"
+
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+public:
+    enum class Layout {
+        sorted,
+        eytzinger
+    };
+
+    FlatMap() = default;
+    /// bulk build from unsorted (key, value) pairs
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last, Layout layout = Layout::sorted, Compare comp = Compare());
+    FlatMap(std::initializer_list<std::pair<K, V>> pairs, Layout layout = Layout::sorted)
+        : FlatMap(pairs.begin(), pairs.end(), layout)
+    {
+    }
+
+    /// add k unless present; true if it was added. Sorted layout only.
+    bool insert(const K& k, const V& value);
+    /// remove k; false if it was absent. Sorted layout only.
+    bool erase(const K& k);
+
+    V* find(const K& k);
+    const V* find(const K& k) const;
+    bool contains(const K& k) const { return find(k) != nullptr; }
+
+    /// switch to the read-only Eytzinger layout
+    void freeze();
+    /// back to the sorted layout
+    void thaw();
+    Layout layout() const { return current_layout; }
+
+    std::size_t size() const { return keys.size(); }
+    bool empty() const { return keys.empty(); }
+    void clear();
+
+    /// call f(key, value) for every entry in ascending key order
+    template <typename F>
+    void for_each(F&& f) { walk(*this, f); }
+    template <typename F>
+    void for_each(F&& f) const { walk(*this, f); }
+
+private:
+    /// how many keys fit one cache line, rounded down to a power of two:
+    /// the descendants that many levels down are adjacent in memory
+    static constexpr std::size_t prefetch_span()
+    {
+        std::size_t span = 1;
+        while (span * 2 * sizeof(K) <= 64)
+            span *= 2;
+        return span;
+    }
+
+    /// Eytzinger index of the first node of an in-order walk, and the
+    /// one after index (size() past the last)
+    std::size_t first_in_order() const;
+    std::size_t next_in_order(std::size_t index) const;
+
+    /// index of the first key not less than k (size() if none)
+    std::size_t lower_bound(const K& k) const;
+    std::size_t sorted_lower_bound(const K& k) const;
+    std::size_t eytzinger_lower_bound(const K& k) const;
+    /// index of k itself, or size()
+    std::size_t position(const K& k) const;
+
+    void require_sorted(const char* operation) const;
+
+    /// for_each() for a FlatMap or a const FlatMap
+    template <typename Self, typename F>
+    static void walk(Self& self, F& f);
+
+    SmallVector<K> keys;
+    SmallVector<V> values;
+    Layout current_layout = Layout::sorted;
+    Compare comp;
+};
+
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+FlatMap<K, V, Compare>::FlatMap(InputIt first, InputIt last, Layout layout, Compare comp)
+    : comp(comp)
+{
+    std::vector<std::pair<K, V>> pairs(first, last);
+    /// stable, so of equal keys the first one given comes first
+    std::stable_sort(pairs.begin(), pairs.end(),
+        [&](const std::pair<K, V>& a, const std::pair<K, V>& b) { return comp(a.first, b.first); });
+
+    keys.reserve(pairs.size());
+    values.reserve(pairs.size());
+    for (auto& pair : pairs) {
+        if (!keys.empty() && !comp(keys[keys.size() - 1], pair.first))
+            continue;
+        keys.push_back(std::move(pair.first));
+        values.push_back(std::move(pair.second));
+    }
+
+    if (layout == Layout::eytzinger)
+        freeze();
+}
+
+template <typename K, typename V, typename Compare>
+std::size_t FlatMap<K, V, Compare>::sorted_lower_bound(const K& k) const
+{
+    return std::lower_bound(keys.begin(), keys.end(), k, comp) - keys.begin();
+}
+
+template <typename K, typename V, typename Compare>
+std::size_t FlatMap<K, V, Compare>::eytzinger_lower_bound(const K& k) const
+{
+    constexpr auto span = prefetch_span();
+    auto n = size();
+    auto base = keys.begin();
+
+    /// walk down without branching on the comparison: right when the
+    /// node is less than k, left otherwise
+    std::size_t index = 0;
+    while (index < n) {
+        /// the span descendants log2(span) levels below index start at
+        /// span * index + span - 1; clamped so the address stays in range
+        __builtin_prefetch(base + std::min(span * index + span - 1, n - 1));
+        index = heap_index::left(index) + comp(base[index], k);
+    }
+
+    /// index fell off the tree. The answer is the last node where the
+    /// walk went left: strip the trailing right turns (ones in index + 1)
+    /// and the left turn above them
+    auto path = index + 1;
+    path >>= __builtin_ctzll(~static_cast<unsigned long long>(path)) + 1;
+    return path == 0 ? n : path - 1;
+}
+
+template <typename K, typename V, typename Compare>
+std::size_t FlatMap<K, V, Compare>::lower_bound(const K& k) const
+{
+    return current_layout == Layout::eytzinger ? eytzinger_lower_bound(k) : sorted_lower_bound(k);
+}
+
+template <typename K, typename V, typename Compare>
+std::size_t FlatMap<K, V, Compare>::position(const K& k) const
+{
+    auto index = lower_bound(k);
+    return index < size() && !comp(k, keys[index]) ? index : size();
+}
+
+template <typename K, typename V, typename Compare>
+V* FlatMap<K, V, Compare>::find(const K& k)
+{
+    auto index = position(k);
+    return index < size() ? &values[index] : nullptr;
+}
+
+template <typename K, typename V, typename Compare>
+const V* FlatMap<K, V, Compare>::find(const K& k) const
+{
+    auto index = position(k);
+    return index < size() ? &values[index] : nullptr;
+}
+
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::require_sorted(const char* operation) const
+{
+    if (current_layout != Layout::sorted)
+        throw std::logic_error(std::string("FlatMap: ") + operation + " on a frozen map; thaw() it first");
+}
+
+template <typename K, typename V, typename Compare>
+bool FlatMap<K, V, Compare>::insert(const K& k, const V& value)
+{
+    require_sorted("insert()");
+    auto index = sorted_lower_bound(k);
+    if (index < size() && !comp(k, keys[index]))
+        return false;
+
+    /// append, then rotate the new entry down into place
+    keys.push_back(k);
+    values.push_back(value);
+    std::rotate(keys.begin() + index, keys.end() - 1, keys.end());
+    std::rotate(values.begin() + index, values.end() - 1, values.end());
+    return true;
+}
+
+template <typename K, typename V, typename Compare>
+bool FlatMap<K, V, Compare>::erase(const K& k)
+{
+    require_sorted("erase()");
+    auto index = position(k);
+    if (index == size())
+        return false;
+
+    std::move(keys.begin() + index + 1, keys.end(), keys.begin() + index);
+    std::move(values.begin() + index + 1, values.end(), values.begin() + index);
+    keys.pop_back();
+    values.pop_back();
+    return true;
+}
+
+template <typename K, typename V, typename Compare>
+std::size_t FlatMap<K, V, Compare>::first_in_order() const
+{
+    std::size_t index = 0;
+    while (heap_index::left(index) < size())
+        index = heap_index::left(index);
+    return index;
+}
+
+template <typename K, typename V, typename Compare>
+std::size_t FlatMap<K, V, Compare>::next_in_order(std::size_t index) const
+{
+    /// leftmost node of the right subtree, if there is one
+    if (heap_index::right(index) < size()) {
+        index = heap_index::right(index);
+        while (heap_index::left(index) < size())
+            index = heap_index::left(index);
+        return index;
+    }
+    /// otherwise climb out of right subtrees; the first ancestor
+    /// reached from its left is next
+    while (index > 0 && index == heap_index::right(heap_index::parent(index)))
+        index = heap_index::parent(index);
+    return index == 0 ? size() : heap_index::parent(index);
+}
+
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::freeze()
+{
+    if (current_layout == Layout::eytzinger)
+        return;
+
+    /// the in-order walk of the implicit tree visits its nodes in
+    /// ascending key order: the i-th sorted entry belongs at the i-th node.
+    /// Permute indices first, so entries are only ever move-constructed
+    std::vector<std::size_t> sorted_index(size());
+    auto node = first_in_order();
+    for (std::size_t i = 0; i < size(); ++i, node = next_in_order(node))
+        sorted_index[node] = i;
+
+    SmallVector<K> tree_keys;
+    SmallVector<V> tree_values;
+    tree_keys.reserve(size());
+    tree_values.reserve(size());
+    for (auto i : sorted_index) {
+        tree_keys.push_back(std::move(keys[i]));
+        tree_values.push_back(std::move(values[i]));
+    }
+
+    keys = std::move(tree_keys);
+    values = std::move(tree_values);
+    current_layout = Layout::eytzinger;
+}
+
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::thaw()
+{
+    if (current_layout == Layout::sorted)
+        return;
+
+    SmallVector<K> sorted_keys;
+    SmallVector<V> sorted_values;
+    sorted_keys.reserve(size());
+    sorted_values.reserve(size());
+    for (auto node = first_in_order(); node < size(); node = next_in_order(node)) {
+        sorted_keys.push_back(std::move(keys[node]));
+        sorted_values.push_back(std::move(values[node]));
+    }
+
+    keys = std::move(sorted_keys);
+    values = std::move(sorted_values);
+    current_layout = Layout::sorted;
+}
+
+template <typename K, typename V, typename Compare>
+void FlatMap<K, V, Compare>::clear()
+{
+    keys.clear();
+    values.clear();
+    current_layout = Layout::sorted;
+}
+
+template <typename K, typename V, typename Compare>
+template <typename Self, typename F>
+void FlatMap<K, V, Compare>::walk(Self& self, F& f)
+{
+    if (self.current_layout == Layout::sorted) {
+        for (std::size_t i = 0; i < self.size(); ++i)
+            f(static_cast<const K&>(self.keys[i]), self.values[i]);
+        return;
+    }
+    for (auto node = self.first_in_order(); node < self.size(); node = self.next_in_order(node))
+        f(static_cast<const K&>(self.keys[node]), self.values[node]);
+}
+
+#endif //FLATMAP_FLATMAP_H
@@ -0,0 +1,102 @@
+/// Lookup latency of FlatMap (sorted and Eytzinger layouts) against
+/// std::map, std::unordered_map and std::lower_bound over a sorted
+/// std::vector, from 1K to 100M keys. Also times the bulk build and
+/// freeze().
+///
+/// Node-based maps above node_limit keys are skipped: at 100M keys
+/// std::map alone needs about 5 GiB.
+///
+/// usage: FlatMap_bench [max_keys] [node_limit]
+/// g++ -std=c++17 -O2 FlatMap_bench.cc
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FlatMap.hpp"
+
+constexpr std::size_t probes_per_size = std::size_t(1) << 22;
+
+template <typename F>
+double ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+/// ns per lookup of every probe through find(k), which returns the value
+template <typename Find>
+void measure(const char* name, const std::vector<std::uint32_t>& probes, Find find)
+{
+    std::uint64_t checksum = 0;
+    auto total = ns([&] {
+        for (auto k : probes)
+            checksum += find(k);
+    });
+    std::cout << "  " << name << ": " << total / probes.size() << " ns/lookup  (checksum " << checksum << ")\n";
+}
+
+void bench(std::size_t n, std::size_t node_limit, std::mt19937& rng)
+{
+    /// distinct keys spread over the 32-bit range, in random order
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs(n);
+    for (std::size_t i = 0; i < n; ++i)
+        pairs[i] = { static_cast<std::uint32_t>(i * 2654435761u), static_cast<std::uint32_t>(i) };
+    std::shuffle(pairs.begin(), pairs.end(), rng);
+
+    std::vector<std::uint32_t> probes(probes_per_size);
+    for (auto& k : probes)
+        k = pairs[rng() % n].first;
+
+    std::cout << n << " keys\n";
+    {
+        std::vector<std::uint32_t> sorted(n);
+        for (std::size_t i = 0; i < n; ++i)
+            sorted[i] = pairs[i].first;
+        std::sort(sorted.begin(), sorted.end());
+        measure("std::lower_bound", probes, [&](std::uint32_t k) {
+            return *std::lower_bound(sorted.begin(), sorted.end(), k);
+        });
+    }
+    {
+        FlatMap<std::uint32_t, std::uint32_t> map;
+        auto build = ns([&] { map = FlatMap<std::uint32_t, std::uint32_t>(pairs.begin(), pairs.end()); });
+        std::cout << "  bulk build: " << build / n << " ns/key\n";
+        measure("FlatMap sorted", probes, [&](std::uint32_t k) { return *map.find(k); });
+        auto freeze = ns([&] { map.freeze(); });
+        std::cout << "  freeze(): " << freeze / n << " ns/key\n";
+        measure("FlatMap eytzinger", probes, [&](std::uint32_t k) { return *map.find(k); });
+    }
+    if (n > node_limit) {
+        std::cout << "  std::map, std::unordered_map: skipped above " << node_limit << " keys\n";
+        return;
+    }
+    {
+        std::map<std::uint32_t, std::uint32_t> map(pairs.begin(), pairs.end());
+        measure("std::map", probes, [&](std::uint32_t k) { return map.find(k)->second; });
+    }
+    {
+        std::unordered_map<std::uint32_t, std::uint32_t> map(pairs.begin(), pairs.end());
+        measure("std::unordered_map", probes, [&](std::uint32_t k) { return map.find(k)->second; });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t max_keys = argc > 1 ? std::stoull(argv[1]) : 100000000;
+    std::size_t node_limit = argc > 2 ? std::stoull(argv[2]) : 10000000;
+    std::mt19937 rng(42);
+
+    for (std::size_t n = 1000; n <= max_keys; n *= 10)
+        bench(n, node_limit, rng);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#ifndef HEAP_SIMPLEHEAP_H
+#define HEAP_SIMPLEHEAP_H
+
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "../Instrumentation.hpp"
+#include "heap_index.hpp"
+#include "parallel_heapify.hpp"
+
+/// CLRS max-heap: build_max_heap, heap sort and insert
+namespace simple_heap {
+
+template <typename T, typename Instrument = NoInstrumentation>
+class Heap : private Instrument {
+private:
+    std::vector<T> items;
+    bool sorted = false;
+    std::size_t heap_size = 0;
+
+public:
+    Heap() = default;
+    explicit Heap(const std::vector<T>& items);
+    Heap(const Heap&) = default;
+    Heap& operator=(const Heap&) = default;
+    Heap(Heap&&) noexcept = default;
+    Heap& operator=(Heap&&) noexcept = default;
+    ~Heap() = default;
+
+    T& operator[](std::size_t i) { return items[i]; }
+    const T& operator[](std::size_t i) const { return items[i]; }
+
+    /// depth: levels already sifted by the calls above this one
+    void max_heapify(Heap&, std::size_t, std::size_t depth = 0);
+    void build_max_heap(Heap&);
+    /// heapify subtrees concurrently on up to `threads` threads
+    void build_max_heap(Heap&, unsigned threads);
+    void insert(const T&);
+
+    T extract_max();
+    T max();
+    void sort();
+
+    std::size_t size() const { return heap_size; }
+
+    void display();
+
+    /// the instrumentation policy, e.g. its stats()
+    const Instrument& instrumentation() const { return *this; }
+    /// zero the policy's stats(), e.g. after an export
+    void reset_instrumentation() { this->reset_stats(); }
+
+private:
+    template <typename U, typename I>
+    friend void heap_up(Heap<U, I>&, std::size_t);
+};
+
+using heap_index::left;
+using heap_index::parent;
+using heap_index::right;
+
+template <typename T, typename Instrument>
+Heap<T, Instrument>::Heap(const std::vector<T>& items)
+    : items(items)
+    , heap_size(items.size())
+{
+    build_max_heap(*this);
+}
+
+template <typename T, typename Instrument>
+void Heap<T, Instrument>::max_heapify(Heap& heap, std::size_t index, std::size_t depth)
+{
+    auto L = left(index), R = right(index), largest = index;
+    heap.on_compare((L < heap_size) + (R < heap_size));
+    if (L < heap_size && heap[L] > heap[index])
+        largest = L;
+    else
+        largest = index;
+
+    if (R < heap_size && heap[R] > heap[largest])
+        largest = R;
+
+    if (largest != index) {
+        std::swap(heap[index], heap[largest]);
+        heap.on_swap();
+        max_heapify(heap, largest, depth + 1);
+    } else {
+        heap.on_sift(depth);
+    }
+}
+
+template <typename T, typename Instrument>
+void Heap<T, Instrument>::build_max_heap(Heap& heap)
+{
+    for (auto i = static_cast<int>(heap.heap_size / 2); i >= 0; --i) {
+        max_heapify(heap, i);
+    }
+}
+
+template <typename T, typename Instrument>
+void Heap<T, Instrument>::build_max_heap(Heap& heap, unsigned threads)
+{
+    /// counts comparisons only; see Instrumentation.hpp
+    instrumentation::with_counted_compare(heap.instrumentation(), [](const T& a, const T& b) { return b > a; },
+        [&](auto comp) { parallel_heapify::build_max_heap(heap.items.data(), heap.heap_size, threads, comp); });
+}
+
+template <typename T, typename Instrument>
+void heap_up(Heap<T, Instrument>& heap, std::size_t index)
+{
+    std::size_t levels = 0;
+    while (index >= 0 && heap[index] > heap[parent(index)]) {
+        std::swap(heap[index], heap[parent(index)]);
+        heap.on_swap();
+        index = parent(index);
+        ++levels;
+    }
+    /// one comparison per level moved, plus the one that stopped it
+    heap.on_compare(levels + 1);
+    heap.on_sift(levels);
+}
+
+template <typename T, typename Instrument>
+void Heap<T, Instrument>::insert(const T& elem)
+{
+    if (sorted) {
+        build_max_heap(*this);
+        sorted = false;
+    }
+
+    items.emplace_back(elem);
+    heap_size = items.size();
+    heap_up(*this, heap_size - 1);
+}
+
+template <typename T, typename Instrument>
+T Heap<T, Instrument>::extract_max()
+{
+    std::swap(items.front(), items.back());
+    auto elem = items.back();
+    items.pop_back();
+    heap_size = items.size();
+    build_max_heap(*this);
+    return elem;
+}
+
+template <typename T, typename Instrument>
+void Heap<T, Instrument>::sort()
+{
+    auto original_size = heap_size;
+    build_max_heap(*this);
+    for (auto i = static_cast<int>(heap_size - 1); i > 0; --i) {
+        std::swap(items[0], items[i]);
+        heap_size--;
+        max_heapify(*this, 0);
+    }
+
+    sorted = true;
+    heap_size = original_size;
+}
+
+template <typename T, typename Instrument>
+T Heap<T, Instrument>::max()
+{
+    return items.front();
+}
+
+template <typename T, typename Instrument>
+void Heap<T, Instrument>::display()
+{
+    for (auto& elem : items) {
+        std::cout << elem << " ";
+    }
+    std::cout << '\n';
+}
+
+} // namespace simple_heap
+
+#endif //HEAP_SIMPLEHEAP_H
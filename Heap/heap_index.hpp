@@ -0,0 +1,18 @@
+// Index math of an implicit binary tree stored breadth-first in an array,
+// shared by the heaps and FlatMap's Eytzinger layout.
+
+#ifndef HEAP_HEAP_INDEX_H
+#define HEAP_HEAP_INDEX_H
+
+#include <cstddef>
+
+namespace heap_index {
+
+constexpr std::size_t left(std::size_t index) { return (2 * index) + 1; }
+constexpr std::size_t right(std::size_t index) { return (2 * index) + 2; }
+/// the root is its own parent
+constexpr std::size_t parent(std::size_t index) { return index > 0 ? (index - 1) / 2 : 0; }
+
+} // namespace heap_index
+
+#endif //HEAP_HEAP_INDEX_H
@@ -0,0 +1,287 @@
+#ifndef HEAP_MIN_MAX_TEMPLATE_H
+#define HEAP_MIN_MAX_TEMPLATE_H
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Instrumentation.hpp"
+#include "parallel_heapify.hpp"
+
+/// one HeapBase, specialized into Heap<T, Mode::Min> and Heap<T, Mode::Max>
+namespace min_max {
+
+enum class Mode { Min, Max };
+
+template <typename T, Mode M, typename Instrument = NoInstrumentation>
+struct HeapBase : private Instrument {
+    /// default
+    HeapBase() = default;
+    /// Heap does not acquire resources
+    ~HeapBase() = default;
+    /// copy constructor
+    HeapBase(const HeapBase&);
+    /// copy assignment
+    HeapBase& operator=(const HeapBase&);
+    ///  move constructor
+    HeapBase(HeapBase&&) noexcept = default;
+    /// move assignment: use vector move assignment
+    HeapBase& operator=(HeapBase&&) noexcept = default;
+
+    /// get a reference to the root
+    T& top();
+    /// get reference to parent node
+    T& parent(int index) { return items[get_parent_index(index)]; }
+    /// get reference to left_child node
+    T& left_child(int index) { return items[get_left_child(index)]; }
+    /// get reference to right_child node
+    T& right_child(int index) { return items[get_right_child(index)]; }
+    void max_heapify();
+    void build_max_heap();
+    /// heapify subtrees concurrently on up to `threads` threads
+    void build_max_heap(unsigned threads);
+
+    /// container for 'nodes' of the heap allow vector
+    /// to handle allocation if the heap needs to grow
+    std::vector<T> items;
+    /**
+     * sometimes it is helpful if indexes are signed integer values
+     * I currently am unsure if I am going to write an algorithm where
+     * a left index and right index may cross and either left or right
+     * become negative, sometimes it can be a helpful loop invariant
+     */
+    /// size of the heap
+    int size = 0;
+    /// get integer index of left child
+    int get_left_child(int parent_index) { return (2 * parent_index) + 1; };
+    /// get integer index of right child
+    int get_right_child(int parent_index) { return (2 * parent_index) + 2; }
+    /// get parent index of right child
+    int get_parent_index(int child_index) { return (child_index - 1) / 2; };
+
+    /// is left child index in range [0, size)
+    bool has_left_child(int index) { return get_left_child(index) < size; }
+    /// is right child index in range [0, size)
+    bool has_right_child(int index) { return get_right_child(index) < size; }
+    /// is parent index in range [0, size), if at index zero it is the root
+    bool has_parent(int index) { return get_parent_index(index) >= 0; }
+
+    /// extract root of heap
+    T extract();
+    /// add node to the heap
+    void add(const T&);
+    /// heapify_down: reorder heap from the bottom up
+    void heapify_up();
+    /// heapify_down: reorder heap from the top down
+    void heapify_down();
+    
+    void check_in_range(const std::string&, const char*, const char*);
+    void not_in_range(const std::string&, const char*, const char*);
+    virtual void print() = 0;
+
+    /// the instrumentation policy, e.g. its stats()
+    const Instrument& instrumentation() const { return *this; }
+    /// zero the policy's stats(), e.g. after an export
+    void reset_instrumentation() { this->reset_stats(); }
+};
+
+template <typename T, Mode M, typename Instrument>
+HeapBase<T, M, Instrument>::HeapBase(const HeapBase& rhs)
+    : Instrument(rhs)
+    , items(rhs.items)
+    , size(rhs.size)
+{
+}
+
+template <typename T, Mode M, typename Instrument>
+HeapBase<T, M, Instrument>& HeapBase<T, M, Instrument>::operator=(const HeapBase<T, M, Instrument>& rhs)
+{
+    items = rhs.items;
+    size = rhs.size;
+    return *this;
+}
+
+inline std::string error_msg(const std::string& msg, const char* func, const char* sig)
+{
+    auto function = std::string(func);
+    auto signature = std::string(sig);
+    return msg + ": cannot " + func + "()\n" + signature;
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::not_in_range(const std::string& msg, const char* func, const char* sig)
+{
+    throw std::length_error(error_msg(msg, func, sig));
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::check_in_range(const std::string& msg, const char* func, const char* sig)
+{
+    if (items.empty()) {
+        not_in_range(msg, func, sig);
+    }
+}
+
+template <typename T, Mode M, typename Instrument>
+T& HeapBase<T, M, Instrument>::top()
+{
+    check_in_range("empty heap", __func__, __PRETTY_FUNCTION__);
+    return items[0];
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::heapify_up()
+{
+    auto index = size - 1;
+    std::size_t levels = 0;
+    while (has_parent(index) && parent(index) > items[index]) {
+        std::swap(parent(index), items[index]);
+        this->on_swap();
+        index = get_parent_index(index);
+        ++levels;
+    }
+    /// one comparison per level moved, plus the one that stopped it
+    this->on_compare(levels + 1);
+    this->on_sift(levels);
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::heapify_down()
+{
+    int index = 0;
+    std::size_t levels = 0;
+    while (has_left_child(index)) {
+        int smaller_child_index = get_left_child(index);
+        this->on_compare(has_right_child(index) ? 2 : 1);
+
+        if (has_right_child(index) && right_child(index) > left_child(index)) {
+            smaller_child_index = get_right_child(index);
+        }
+
+        if (items[index] < items[smaller_child_index]) {
+            break;
+        } else {
+            std::swap(items[smaller_child_index], items[index]);
+            this->on_swap();
+        }
+        index = smaller_child_index;
+        ++levels;
+    }
+    this->on_sift(levels);
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::add(const T& elem)
+{
+    items.push_back(elem);
+    ++size;
+    heapify_up();
+}
+
+template <typename T, Mode M, typename Instrument>
+T HeapBase<T, M, Instrument>::extract()
+{
+    check_in_range("empty heap", __func__, __PRETTY_FUNCTION__);
+    auto item = items[0];
+    items[0] = items[--size];
+    items.pop_back();
+    heapify_down();
+    return item;
+}
+
+inline int left(int index) { return (2 * index) + 1; }
+inline int right(int index) { return (2 * index) + 2; }
+
+/// depth: levels already sifted by the calls above this one
+template <typename T, typename Instrument>
+void _max_heapify(std::vector<T>& A, int index, const Instrument& instrument, std::size_t depth = 0)
+{
+    int l = left(index);
+    int r = right(index);
+    int largest = 0;
+    instrument.on_compare((l < A.size()) + (r < A.size()));
+    if (l < A.size() && A[l] > A[index]) {
+        largest = l;
+    } else {
+        largest = index;
+    }
+
+    if (r < A.size() && A[r] > A[largest]) {
+        largest = r;
+    }
+
+    if (largest != index) {
+        std::swap(A[index], A[largest]);
+        instrument.on_swap();
+        _max_heapify(A, largest, instrument, depth + 1);
+    } else {
+        instrument.on_sift(depth);
+    }
+}
+
+template <typename T, typename Instrument>
+void _build_max_heap(std::vector<T>& A, const Instrument& instrument)
+{
+    for (auto index = static_cast<int>(A.size() / 2); index >= 0; --index) {
+        _max_heapify(A, index, instrument);
+    }
+}
+
+/// counts comparisons only; see Instrumentation.hpp
+template <typename T, typename Instrument>
+void _build_max_heap(std::vector<T>& A, unsigned threads, const Instrument& instrument)
+{
+    instrumentation::with_counted_compare(instrument, [](const T& a, const T& b) { return b > a; },
+        [&](auto comp) { parallel_heapify::build_max_heap(A.data(), A.size(), threads, comp); });
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::max_heapify()
+{
+    _max_heapify(items, 0, instrumentation());
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::build_max_heap()
+{
+    _build_max_heap(items, instrumentation());
+}
+
+template <typename T, Mode M, typename Instrument>
+void HeapBase<T, M, Instrument>::build_max_heap(unsigned threads)
+{
+    _build_max_heap(items, threads, instrumentation());
+}
+
+template <typename T, Mode M, typename Instrument = NoInstrumentation>
+struct Heap : HeapBase<T, M, Instrument> {
+};
+
+template <typename T, typename Instrument>
+struct Heap<T, Mode::Min, Instrument> : HeapBase<T, Mode::Min, Instrument> {
+    void print() override;
+};
+
+template <typename T, typename Instrument>
+void Heap<T, Mode::Min, Instrument>::print()
+{
+    std::cout << "Min" << std::endl;
+}
+
+template <typename T, typename Instrument>
+struct Heap<T, Mode::Max, Instrument> : HeapBase<T, Mode::Min, Instrument> {
+    void print() override;
+};
+
+template <typename T, typename Instrument>
+void Heap<T, Mode::Max, Instrument>::print()
+{
+    std::cout << "Max" << std::endl;
+}
+
+} // namespace min_max
+
+#endif //HEAP_MIN_MAX_TEMPLATE_H
@@ -0,0 +1,226 @@
+// Parallel bulk heap construction for very large max-heaps.
+//
+// build_max_heap() in CLRS walks the internal nodes from floor(n/2) down to
+// the root, sifting each one down. Every subtree below some level d is
+// independent of its siblings, so the 2^d subtrees rooted at level d can be
+// heapified concurrently; only the top d levels have to be finished serially.
+//
+// Each subtree is built depth-first: once a subtree is small enough to stay
+// resident in cache it is heapified level by level, bottom up, otherwise its
+// two children are built first and its root is sifted down last. Sift-down
+// itself is iterative and moves a "hole" instead of swapping at every level.
+//
+// The worker threads are kept in a process-wide pool, started on first use,
+// so a call pays a wake-up rather than a thread creation per worker.
+
+#ifndef HEAP_PARALLEL_HEAPIFY_H
+#define HEAP_PARALLEL_HEAPIFY_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace parallel_heapify {
+
+/// subtrees whose nodes fit in this many bytes are heapified without
+/// descending any further (roughly half of a typical L2)
+constexpr std::size_t block_bytes = 256 * 1024;
+
+/// subtrees handed to each worker; more than one per thread evens out
+/// the ragged bottom level of the heap
+constexpr std::size_t subtrees_per_thread = 4;
+
+/// below this many elements threads cost more than they save
+constexpr std::size_t serial_cutoff = 1 << 16;
+
+/// threads that outlive one build_max_heap() call; run() hands them a job
+class WorkerPool {
+public:
+    static WorkerPool& instance()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    /// call job() on this thread and on `threads - 1` pool threads, and
+    /// return once every call has returned; one run() at a time
+    void run(unsigned threads, const std::function<void()>& job)
+    {
+        std::lock_guard<std::mutex> one_at_a_time(running);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (workers.size() + 1 < threads) {
+            auto id = static_cast<unsigned>(workers.size());
+            workers.emplace_back([this, id] { work(id); });
+        }
+        current = &job;
+        helpers = threads - 1;
+        pending = helpers;
+        ++round;
+        lock.unlock();
+        wake.notify_all();
+
+        job();
+
+        lock.lock();
+        done.wait(lock, [&] { return pending == 0; });
+        current = nullptr;
+    }
+
+private:
+    WorkerPool() = default;
+
+    void work(unsigned id)
+    {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || round != seen; });
+            if (stopping)
+                return;
+            seen = round;
+            /// only the first `helpers` workers take part in this round
+            if (id >= helpers)
+                continue;
+            auto job = current;
+            lock.unlock();
+            (*job)();
+            lock.lock();
+            if (--pending == 0)
+                done.notify_one();
+        }
+    }
+
+    std::mutex running;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+    const std::function<void()>* current = nullptr;
+    std::uint64_t round = 0;
+    unsigned helpers = 0;
+    unsigned pending = 0;
+    bool stopping = false;
+};
+
+/// iterative max_heapify: sift A[index] down within A[0, n)
+template <typename T, typename Compare>
+void max_heapify(T* A, std::size_t n, std::size_t index, Compare comp)
+{
+    auto elem = std::move(A[index]);
+    auto child = 2 * index + 1;
+    while (child < n) {
+        /// pick the larger of the two children
+        if (child + 1 < n && comp(A[child], A[child + 1]))
+            ++child;
+        if (!comp(elem, A[child]))
+            break;
+        A[index] = std::move(A[child]);
+        index = child;
+        child = 2 * index + 1;
+    }
+    A[index] = std::move(elem);
+}
+
+/// number of levels of the subtree rooted at root that lie within [0, n)
+inline std::size_t subtree_levels(std::size_t root, std::size_t n)
+{
+    std::size_t levels = 0;
+    /// level j of the subtree begins at index (root + 1) * 2^j - 1
+    for (auto first = root; first < n; first = 2 * first + 1)
+        ++levels;
+    return levels;
+}
+
+/// heapify the subtree rooted at root, assuming nothing about its contents
+template <typename T, typename Compare>
+void build_subtree(T* A, std::size_t n, std::size_t root, Compare comp)
+{
+    auto levels = subtree_levels(root, n);
+    if (levels < 2)
+        return;
+
+    /// a subtree of L levels holds at most 2^L - 1 nodes
+    auto nodes = (std::size_t(1) << levels) - 1;
+    if (nodes * sizeof(T) > block_bytes) {
+        build_subtree(A, n, 2 * root + 1, comp);
+        build_subtree(A, n, 2 * root + 2, comp);
+        max_heapify(A, n, root, comp);
+        return;
+    }
+
+    /// small enough to stay in cache: sift down every internal node of
+    /// the subtree, one level at a time from the deepest internal level
+    for (auto level = levels - 1; level-- > 0;) {
+        auto first = ((root + 1) << level) - 1;
+        auto last = std::min(first + (std::size_t(1) << level), n);
+        for (auto i = last; i-- > first;)
+            max_heapify(A, n, i, comp);
+    }
+}
+
+/// heapify A[0, n) using up to `threads` threads (0 means all cores)
+template <typename T, typename Compare = std::less<T>>
+void build_max_heap(T* A, std::size_t n, unsigned threads = 0, Compare comp = Compare())
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (threads == 1 || n < serial_cutoff) {
+        build_subtree(A, n, 0, comp);
+        return;
+    }
+
+    /// shallowest level d with enough subtrees to keep every thread busy;
+    /// level d occupies indices [2^d - 1, 2^(d + 1) - 1)
+    std::size_t depth = 0;
+    while ((std::size_t(1) << depth) < subtrees_per_thread * threads
+        && (std::size_t(2) << depth) - 1 < n)
+        ++depth;
+
+    auto first = (std::size_t(1) << depth) - 1;
+    auto last = std::min((std::size_t(2) << depth) - 1, n);
+
+    /// workers pull subtree roots off a shared counter until none are left
+    std::atomic<std::size_t> next{ first };
+    auto worker = [&] {
+        for (auto root = next++; root < last; root = next++)
+            build_subtree(A, n, root, comp);
+    };
+
+    WorkerPool::instance().run(threads, worker);
+
+    /// the top `depth` levels sit on already-built subtrees
+    for (auto i = first; i-- > 0;)
+        max_heapify(A, n, i, comp);
+}
+
+template <typename T, typename Compare = std::less<T>>
+void build_max_heap(std::vector<T>& A, unsigned threads = 0, Compare comp = Compare())
+{
+    build_max_heap(A.data(), A.size(), threads, comp);
+}
+
+} // namespace parallel_heapify
+
+#endif //HEAP_PARALLEL_HEAPIFY_H
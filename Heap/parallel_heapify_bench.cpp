@@ -0,0 +1,90 @@
+/// Bulk heapify benchmark: serial CLRS build_max_heap vs
+/// parallel_heapify::build_max_heap on 1..N threads.
+///
+/// usage: parallel_heapify_bench [elements] [max_threads]
+/// g++ -std=c++17 -O2 -pthread parallel_heapify_bench.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "parallel_heapify.hpp"
+
+/// the recursive textbook version, as in SimpleHeap.cpp
+template <typename T>
+void textbook_max_heapify(std::vector<T>& A, std::size_t index)
+{
+    auto l = 2 * index + 1, r = 2 * index + 2, largest = index;
+    if (l < A.size() && A[l] > A[largest])
+        largest = l;
+    if (r < A.size() && A[r] > A[largest])
+        largest = r;
+    if (largest != index) {
+        std::swap(A[index], A[largest]);
+        textbook_max_heapify(A, largest);
+    }
+}
+
+template <typename T>
+void textbook_build_max_heap(std::vector<T>& A)
+{
+    for (auto i = A.size() / 2 + 1; i-- > 0;)
+        textbook_max_heapify(A, i);
+}
+
+template <typename F>
+double time_ms(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : std::size_t(1) << 25;
+    unsigned max_threads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+    max_threads = std::max(1u, max_threads);
+
+    std::vector<std::uint32_t> input(n);
+    std::mt19937 rng(42);
+    for (auto& x : input)
+        x = rng();
+
+    auto A = input;
+    auto baseline = time_ms([&] { textbook_build_max_heap(A); });
+    if (!std::is_heap(A.begin(), A.end())) {
+        std::cerr << "textbook build_max_heap produced an invalid heap\n";
+        return 1;
+    }
+    std::cout << "elements: " << n << "\n"
+              << "textbook (recursive): " << baseline << " ms\n";
+
+    /// 1, 2, 4, ... and always max_threads itself
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+
+    double one_thread = 0;
+    for (auto threads : counts) {
+        A = input;
+        auto elapsed = time_ms([&] { parallel_heapify::build_max_heap(A, threads); });
+        if (!std::is_heap(A.begin(), A.end())) {
+            std::cerr << threads << " threads produced an invalid heap\n";
+            return 1;
+        }
+        if (threads == 1)
+            one_thread = elapsed;
+        std::cout << threads << " thread(s): " << elapsed << " ms"
+                  << "  speedup vs 1 thread: " << one_thread / elapsed
+                  << "  vs textbook: " << baseline / elapsed << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,303 @@
+/**
+ * --------------- Instrumentation -------------------
+ * Hot-path event hooks shared by SmallVector, the heaps
+ * and DirectAddressTable, chosen by a template parameter:
+ *
+ *     SmallVector<int>                            - NoInstrumentation
+ *     SmallVector<int, CountingInstrumentation>   - counts events
+ *
+ * A container privately inherits its policy and calls
+ * the on_*() hooks below. NoInstrumentation is empty and
+ * its hooks are empty inline functions, so the default
+ * containers are the same size and code as without it.
+ *
+ * CountingInstrumentation adds each event both to the
+ * instance (container.instrumentation().stats()) and to
+ * a per-thread total. The per-thread totals are plain
+ * single-writer counters; instrumentation::total_stats()
+ * sums them over every thread, including threads that
+ * have exited, and instrumentation::dump() writes any
+ * Stats as "name value" lines for a metrics exporter.
+ * Hooks are const so const lookups count too, and the
+ * instance stats are relaxed atomics so several threads
+ * may search one counted container at once.
+ * container.reset_instrumentation() starts the instance
+ * stats over, e.g. after each export.
+ *
+ * Stats stay with the container they describe: a copy
+ * or move of a container starts with fresh stats, and
+ * assigning to a container keeps its own.
+ *
+ * Multi-threaded heap builds (build_max_heap(threads))
+ * count comparisons only: their workers move elements
+ * rather than swap them and sift on other threads.
+ */
+
+#ifndef INSTRUMENTATION_INSTRUMENTATION_H
+#define INSTRUMENTATION_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace instrumentation {
+
+enum class Counter {
+    /// heaps: element comparisons, swaps, heapify_up/heapify_down
+    /// calls and the levels they moved an element
+    comparisons,
+    swaps,
+    sifts,
+    sift_levels,
+    /// SmallVector: growths, elements moved by them, capacity added
+    reallocations,
+    reallocated_elements,
+    capacity_added,
+    /// DirectAddressTable: where each Insert() found its slot
+    fresh_slots,
+    free_list_hits,
+    full_table_inserts,
+    /// DirectAddressTable: Search() calls and the ones that missed
+    lookups,
+    lookup_misses,
+    count
+};
+
+constexpr std::size_t counter_count = static_cast<std::size_t>(Counter::count);
+
+constexpr const char* counter_names[counter_count] = {
+    "comparisons",
+    "swaps",
+    "sifts",
+    "sift_levels",
+    "reallocations",
+    "reallocated_elements",
+    "capacity_added",
+    "fresh_slots",
+    "free_list_hits",
+    "full_table_inserts",
+    "lookups",
+    "lookup_misses",
+};
+
+struct Stats {
+    std::uint64_t& operator[](Counter c) { return values[static_cast<std::size_t>(c)]; }
+    std::uint64_t operator[](Counter c) const { return values[static_cast<std::size_t>(c)]; }
+
+    Stats& operator+=(const Stats& rhs)
+    {
+        for (std::size_t i = 0; i < counter_count; ++i)
+            values[i] += rhs.values[i];
+        return *this;
+    }
+
+    /// call f(name, value) for every counter
+    template <typename F>
+    void for_each(F&& f) const
+    {
+        for (std::size_t i = 0; i < counter_count; ++i)
+            f(counter_names[i], values[i]);
+    }
+
+    std::array<std::uint64_t, counter_count> values {};
+};
+
+namespace detail {
+
+/// one container's stats; any thread may add to them
+struct SharedStats {
+    void add(Counter c, std::uint64_t n)
+    {
+        values[static_cast<std::size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+    }
+    Stats load() const
+    {
+        Stats s;
+        for (std::size_t i = 0; i < counter_count; ++i)
+            s.values[i] = values[i].load(std::memory_order_relaxed);
+        return s;
+    }
+    void clear()
+    {
+        for (auto& v : values)
+            v.store(0, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, counter_count> values {};
+};
+
+/// one thread's totals; only that thread writes them, any thread may
+/// read them, so relaxed atomics without read-modify-write suffice
+struct ThreadTotals;
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadTotals*> live;
+    /// totals of threads that have exited
+    Stats retired;
+};
+
+inline Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+struct ThreadTotals {
+    ThreadTotals()
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(this);
+    }
+    ~ThreadTotals()
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.retired += load();
+        r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+    }
+
+    void add(Counter c, std::uint64_t n)
+    {
+        auto& v = values[static_cast<std::size_t>(c)];
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    Stats load() const
+    {
+        Stats s;
+        for (std::size_t i = 0; i < counter_count; ++i)
+            s.values[i] = values[i].load(std::memory_order_relaxed);
+        return s;
+    }
+
+    std::array<std::atomic<std::uint64_t>, counter_count> values {};
+};
+
+inline ThreadTotals& this_thread()
+{
+    static thread_local ThreadTotals totals;
+    return totals;
+}
+
+} // namespace detail
+
+/// events recorded on the calling thread
+inline Stats thread_stats() { return detail::this_thread().load(); }
+
+/// events recorded on every thread so far
+inline Stats total_stats()
+{
+    auto& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto total = r.retired;
+    for (auto* t : r.live)
+        total += t->load();
+    return total;
+}
+
+/// one "<prefix><name> <value>" line per counter
+inline void dump(std::ostream& os, const Stats& stats, const char* prefix = "containers_")
+{
+    stats.for_each([&](const char* name, std::uint64_t value) { os << prefix << name << ' ' << value << '\n'; });
+}
+
+inline void dump(std::ostream& os) { dump(os, total_stats()); }
+
+/// call f(c) where c is comp, counting its calls into policy.on_compare();
+/// for algorithms that call comp from several threads, so the policy is
+/// only touched from this one
+template <typename Instrument, typename Compare, typename F>
+void with_counted_compare(const Instrument& policy, Compare comp, F&& f)
+{
+    if constexpr (Instrument::enabled) {
+        std::atomic<std::uint64_t> comparisons { 0 };
+        f([&comparisons, comp](const auto& a, const auto& b) {
+            comparisons.fetch_add(1, std::memory_order_relaxed);
+            return comp(a, b);
+        });
+        policy.on_compare(comparisons.load(std::memory_order_relaxed));
+    } else {
+        f(comp);
+    }
+}
+
+} // namespace instrumentation
+
+/// the default: every hook is empty and the policy takes no space
+struct NoInstrumentation {
+    /// false: containers may skip work done only to feed the hooks
+    static constexpr bool enabled = false;
+
+    void on_compare(std::size_t = 1) const { }
+    void on_swap() const { }
+    void on_sift(std::size_t) const { }
+    void on_grow(std::size_t, std::size_t, std::size_t) const { }
+    void on_fresh_slot() const { }
+    void on_free_list_hit() const { }
+    void on_table_full() const { }
+    void on_lookup(bool) const { }
+    void on_lookups(std::size_t, std::size_t) const { }
+    void reset_stats() { }
+};
+
+class CountingInstrumentation {
+public:
+    static constexpr bool enabled = true;
+
+    CountingInstrumentation() = default;
+    /// a copy starts counting from zero
+    CountingInstrumentation(const CountingInstrumentation&) { }
+    /// the assigned-to container keeps its own stats
+    CountingInstrumentation& operator=(const CountingInstrumentation&) { return *this; }
+
+    /// events on this container only
+    instrumentation::Stats stats() const { return instance.load(); }
+    void reset_stats() { instance.clear(); }
+
+    void on_compare(std::size_t n = 1) const { record(instrumentation::Counter::comparisons, n); }
+    void on_swap() const { record(instrumentation::Counter::swaps); }
+    void on_sift(std::size_t levels) const
+    {
+        record(instrumentation::Counter::sifts);
+        record(instrumentation::Counter::sift_levels, levels);
+    }
+    void on_grow(std::size_t old_capacity, std::size_t new_capacity, std::size_t moved) const
+    {
+        record(instrumentation::Counter::reallocations);
+        record(instrumentation::Counter::reallocated_elements, moved);
+        record(instrumentation::Counter::capacity_added, new_capacity - old_capacity);
+    }
+    void on_fresh_slot() const { record(instrumentation::Counter::fresh_slots); }
+    void on_free_list_hit() const { record(instrumentation::Counter::free_list_hits); }
+    void on_table_full() const { record(instrumentation::Counter::full_table_inserts); }
+    void on_lookup(bool hit) const
+    {
+        record(instrumentation::Counter::lookups);
+        if (!hit)
+            record(instrumentation::Counter::lookup_misses);
+    }
+    /// a batch of n lookups
+    void on_lookups(std::size_t n, std::size_t hits) const
+    {
+        record(instrumentation::Counter::lookups, n);
+        record(instrumentation::Counter::lookup_misses, n - hits);
+    }
+
+private:
+    void record(instrumentation::Counter c, std::uint64_t n = 1) const
+    {
+        instance.add(c, n);
+        instrumentation::detail::this_thread().add(c, n);
+    }
+
+    /// mutable: const lookups are events too
+    mutable instrumentation::detail::SharedStats instance;
+};
+
+#endif //INSTRUMENTATION_INSTRUMENTATION_H
@@ -1,13 +1,17 @@
 // Created by Eric Sanchez @ericd34n on 4/13/18.
-// TODO reserve(), construction from std::initializer_list
+// TODO construction from std::initializer_list
 
 #ifndef SMALLVECTOR_SMALLVECTOR_H
 #define SMALLVECTOR_SMALLVECTOR_H
 
 #include <iostream>
+#include <memory>
+#include <utility>
 
-template <typename T>
-class SmallVector {
+#include "Instrumentation.hpp"
+
+template <typename T, typename Instrument = NoInstrumentation>
+class SmallVector : private Instrument {
 public:
     SmallVector()
         : elements(nullptr)
@@ -30,18 +34,35 @@ public:
     void push_back(const T&);
     /// Move
     void push_back(T&&);
+    /// destroy the last element
+    void pop_back() { alloc_traits::destroy(alloc, --first_free); }
+    /// make room for at least n elements without reallocating
+    void reserve(std::size_t n);
+    /// grow with value-initialized elements or shrink from the back
+    void resize(std::size_t n);
+    /// destroy every element, keep the space
+    void clear();
 	
     T& operator[](std::size_t n) { return elements[n]; }
     const T& operator[](std::size_t n) const { return elements[n]; }
     
     std::size_t size() const { return first_free - elements; }
-    std::size_t capacity() const { return current_capacity - first_free; }
+    std::size_t capacity() const { return current_capacity - elements; }
+    bool empty() const { return first_free == elements; }
     T* begin() const { return elements; }
     T* end() const { return first_free; }
 
+    /// the instrumentation policy, e.g. its stats()
+    const Instrument& instrumentation() const { return *this; }
+    /// zero the policy's stats(), e.g. after an export
+    void reset_instrumentation() { this->reset_stats(); }
+
 private:
     /// allocator
     static std::allocator<T> alloc;
+    /// construct() and destroy() go through the traits: the allocator's
+    /// own members were deprecated in C++17 and removed in C++20
+    using alloc_traits = std::allocator_traits<std::allocator<T>>;
 
     /// check capacity before reallocation
     void check_then_allocate()
@@ -57,6 +78,8 @@ private:
     void free();
     /// allocate more space when necessary
     void reallocate();
+    /// move the elements into exactly new_capacity slots
+    void reallocate(std::size_t new_capacity);
     /// pointer to the beginning of the first element
     T* elements;
     /// pointer to the first "free" element position
@@ -65,11 +88,11 @@ private:
     T* current_capacity;
 };
 
-template <typename T>
-std::allocator<T> SmallVector<T>::alloc;
+template <typename T, typename Instrument>
+std::allocator<T> SmallVector<T, Instrument>::alloc;
 
-template <typename T>
-std::pair<T*, T*> SmallVector<T>::alloc_then_copy(const T* begin, const T* end)
+template <typename T, typename Instrument>
+std::pair<T*, T*> SmallVector<T, Instrument>::alloc_then_copy(const T* begin, const T* end)
 {
     /// allocate for range [e, b], being explicit by
     /// using `range`  
@@ -82,16 +105,17 @@ std::pair<T*, T*> SmallVector<T>::alloc_then_copy(const T* begin, const T* end)
     return { data, std::uninitialized_copy(begin, end, data) };
 };
 
-template <typename T>
-SmallVector<T>::SmallVector(const SmallVector& small_vector)
+template <typename T, typename Instrument>
+SmallVector<T, Instrument>::SmallVector(const SmallVector& small_vector)
+    : Instrument(small_vector)
 {
     auto newly_allocated_data = alloc_then_copy(small_vector.begin(), small_vector.end());
     elements = newly_allocated_data.first;
     first_free = current_capacity = newly_allocated_data.second;
 }
 
-template <typename T>
-SmallVector<T>& SmallVector<T>::operator=(const SmallVector& rhs)
+template <typename T, typename Instrument>
+SmallVector<T, Instrument>& SmallVector<T, Instrument>::operator=(const SmallVector& rhs)
 {
     auto newly_allocated_data = alloc_then_copy(rhs.begin(), rhs.end());
     free();
@@ -100,9 +124,10 @@ SmallVector<T>& SmallVector<T>::operator=(const SmallVector& rhs)
     return *this;
 }
 
-template <typename T>
-SmallVector<T>::SmallVector(SmallVector&& small_vector) noexcept
-    : elements(small_vector.elements)
+template <typename T, typename Instrument>
+SmallVector<T, Instrument>::SmallVector(SmallVector&& small_vector) noexcept
+    : Instrument(std::move(small_vector))
+    , elements(small_vector.elements)
     , first_free(small_vector.first_free)
     , current_capacity(small_vector.current_capacity)
 {
@@ -110,8 +135,8 @@ SmallVector<T>::SmallVector(SmallVector&& small_vector) noexcept
     small_vector.elements = small_vector.first_free = small_vector.current_capacity = nullptr;
 }
 
-template <typename T>
-SmallVector<T>& SmallVector<T>::operator=(SmallVector&& rhs) noexcept
+template <typename T, typename Instrument>
+SmallVector<T, Instrument>& SmallVector<T, Instrument>::operator=(SmallVector&& rhs) noexcept
 {
     /// adjust for possible self assignment
     if (this != &rhs) {
@@ -126,8 +151,8 @@ SmallVector<T>& SmallVector<T>::operator=(SmallVector&& rhs) noexcept
     return *this;
 }
 
-template <typename T>
-void SmallVector<T>::free()
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::free()
 {
     /**
      * If there are elements to destroy, destroy
@@ -137,7 +162,7 @@ void SmallVector<T>::free()
      */
     if (elements) {
         for (auto iter = first_free; iter != elements;) {
-            alloc.destroy(--iter);
+            alloc_traits::destroy(alloc, --iter);
         }
         /**
 	 * http://en.cppreference.com/w/cpp/memory/allocator/deallocate
@@ -152,13 +177,18 @@ void SmallVector<T>::free()
 }
 
 /// destroy and free elements
-template <typename T>
-SmallVector<T>::~SmallVector() { free(); }
+template <typename T, typename Instrument>
+SmallVector<T, Instrument>::~SmallVector() { free(); }
+
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::reallocate()
+{
+    reallocate(size() ? 2 * size() : 3);
+}
 
-template <typename T>
-void SmallVector<T>::reallocate()
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::reallocate(std::size_t new_capacity)
 {
-    auto new_capacity = size() ? 2 * size() : 3;
     /**
 	 * Allocates raw, unconstructed memory to hold n
 	 * objects of type T.
@@ -172,6 +202,7 @@ void SmallVector<T>::reallocate()
 	 * this function is called.
 	 */
     auto first = alloc.allocate(new_capacity);
+    this->on_grow(capacity(), new_capacity, size());
 
     /// Iterator to the element past the last element copied.
     auto last = std::uninitialized_copy(std::make_move_iterator(begin()),
@@ -182,18 +213,46 @@ void SmallVector<T>::reallocate()
     first_free = last;
     current_capacity = elements + new_capacity;
 }
-template <typename T>
-void SmallVector<T>::push_back(const T& lvalue_elem)
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::reserve(std::size_t n)
+{
+    if (n > capacity()) {
+        reallocate(n);
+    }
+}
+
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::resize(std::size_t n)
+{
+    reserve(n);
+    while (size() < n) {
+        alloc_traits::construct(alloc, first_free++);
+    }
+    while (size() > n) {
+        pop_back();
+    }
+}
+
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::clear()
+{
+    while (first_free != elements) {
+        pop_back();
+    }
+}
+
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::push_back(const T& lvalue_elem)
 {
     check_then_allocate();
-    alloc.construct(first_free++, lvalue_elem);
+    alloc_traits::construct(alloc, first_free++, lvalue_elem);
 }
 
-template <typename T>
-void SmallVector<T>::push_back(T&& rvalue_elem)
+template <typename T, typename Instrument>
+void SmallVector<T, Instrument>::push_back(T&& rvalue_elem)
 {
     check_then_allocate();
-    alloc.construct(first_free++, std::move(rvalue_elem));
+    alloc_traits::construct(alloc, first_free++, std::move(rvalue_elem));
 }
 
 #endif //SMALLVECTOR_SMALLVECTOR_H
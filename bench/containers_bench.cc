@@ -0,0 +1,690 @@
+/// Standardized workloads over every container and its std:: equivalent,
+/// reported as JSON so runs can be diffed between releases.
+///
+/// For each (container, workload, payload size) the workload is repeated
+/// and the repetition with the median time is reported:
+///
+///   ns_per_op, ops_per_sec - wall time of the timed region only
+///   allocations, allocated_bytes - calls to operator new in that region
+///   cache_misses, cache_references - hardware counters via perf_event_open,
+///       null where the kernel or container does not allow them
+///
+/// usage: containers_bench [--quick] [--size N] [--reps R] [--filter S] [-o FILE]
+///   --size   elements per workload (fewer for large payloads), default 2^20
+///   --filter only run cases whose "container/workload" contains S
+///
+/// Built by the top-level CMakeLists.txt as containers_bench.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "DirectAddressTable/DirectAddressTable.hpp"
+#include "FlatMap.hpp"
+#include "Heap.hpp"
+#include "Heap/SimpleHeap.hpp"
+#include "Heap/parallel_heapify.hpp"
+#include "SmallVector.hpp"
+
+#ifndef CONTAINERS_BUILD_TYPE
+#define CONTAINERS_BUILD_TYPE "unknown"
+#endif
+
+// ---- allocation counting ----------------------------------------------------
+
+namespace {
+std::atomic<std::uint64_t> allocation_count { 0 };
+std::atomic<std::uint64_t> allocation_bytes { 0 };
+
+void* counted_alloc(std::size_t n, std::size_t alignment)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(n, std::memory_order_relaxed);
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+        p = std::malloc(n ? n : 1);
+    else if (posix_memalign(&p, alignment, n ? n : 1) != 0)
+        p = nullptr;
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+} // namespace
+
+void* operator new(std::size_t n) { return counted_alloc(n, 0); }
+void* operator new[](std::size_t n) { return counted_alloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<std::size_t>(a)); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept
+{
+    try {
+        return counted_alloc(n, 0);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t n, const std::nothrow_t& tag) noexcept { return operator new(n, tag); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept
+{
+    try {
+        return counted_alloc(n, static_cast<std::size_t>(a));
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t& tag) noexcept { return operator new(n, a, tag); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+// ---- hardware counters --------------------------------------------------------
+
+/// cache references and misses of this thread and of every thread it
+/// starts after construction (parallel_heapify's worker pool), user
+/// space only
+class CacheCounters {
+public:
+    CacheCounters()
+    {
+#ifdef __linux__
+        leader = open(PERF_COUNT_HW_CACHE_REFERENCES, -1);
+        if (leader >= 0)
+            member = open(PERF_COUNT_HW_CACHE_MISSES, leader);
+        if (leader < 0 || member < 0) {
+            error = std::string("perf_event_open: ") + std::strerror(errno);
+            close_all();
+        }
+#else
+        error = "perf_event_open: not Linux";
+#endif
+    }
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+    ~CacheCounters() { close_all(); }
+
+    bool available() const { return leader >= 0; }
+    const std::string& unavailable_reason() const { return error; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (available()) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+    /// {references, misses}; zeros when unavailable
+    std::pair<std::uint64_t, std::uint64_t> stop()
+    {
+#ifdef __linux__
+        if (available()) {
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            /// PERF_FORMAT_GROUP: count of events, then one value each
+            std::uint64_t values[3] {};
+            if (read(leader, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)))
+                return { values[1], values[2] };
+        }
+#endif
+        return { 0, 0 };
+    }
+
+private:
+#ifdef __linux__
+    static int open(std::uint64_t config, int group)
+    {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        /// child threads get their own counters, summed into ours on read
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+    void close_all()
+    {
+#ifdef __linux__
+        if (member >= 0)
+            ::close(member);
+        if (leader >= 0)
+            ::close(leader);
+#endif
+        member = leader = -1;
+    }
+
+    int leader = -1;
+    int member = -1;
+    std::string error;
+};
+
+// ---- harness -----------------------------------------------------------------
+
+/// keep the optimizer from discarding a result
+template <typename T>
+void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Options {
+    std::size_t size = std::size_t(1) << 20;
+    unsigned reps = 5;
+    std::string filter;
+};
+
+struct Sample {
+    double ns = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t cache_references = 0;
+    std::uint64_t cache_misses = 0;
+};
+
+class Suite {
+public:
+    explicit Suite(Options options)
+        : options(std::move(options))
+    {
+    }
+
+    const Options& config() const { return options; }
+
+    /// Setup builds the untimed starting state; Body runs the workload
+    /// on it and returns the number of operations it performed
+    template <typename Setup, typename Body>
+    void run(const std::string& container, bool baseline, const std::string& workload,
+        std::size_t payload_bytes, std::size_t n, Setup setup, Body body)
+    {
+        auto name = container + "/" + workload;
+        if (name.find(options.filter) == std::string::npos)
+            return;
+
+        std::vector<Sample> samples;
+        std::size_t ops = 0;
+        for (unsigned rep = 0; rep < options.reps; ++rep) {
+            auto state = setup();
+            Sample s;
+            auto allocations = allocation_count.load(std::memory_order_relaxed);
+            auto bytes = allocation_bytes.load(std::memory_order_relaxed);
+            counters.start();
+            auto start = std::chrono::steady_clock::now();
+            ops = body(state);
+            auto stop = std::chrono::steady_clock::now();
+            std::tie(s.cache_references, s.cache_misses) = counters.stop();
+            s.allocations = allocation_count.load(std::memory_order_relaxed) - allocations;
+            s.allocated_bytes = allocation_bytes.load(std::memory_order_relaxed) - bytes;
+            s.ns = std::chrono::duration<double, std::nano>(stop - start).count();
+            samples.push_back(s);
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end(),
+            [](const Sample& a, const Sample& b) { return a.ns < b.ns; });
+        auto& median = samples[samples.size() / 2];
+
+        std::ostringstream out;
+        auto ns_per_op = median.ns / ops;
+        out << "    {\"container\": \"" << container << "\", \"baseline\": " << (baseline ? "true" : "false")
+            << ", \"workload\": \"" << workload << "\", \"payload_bytes\": " << payload_bytes
+            << ", \"n\": " << n << ", \"ops\": " << ops << ", \"ns_per_op\": " << ns_per_op
+            << ", \"ops_per_sec\": " << 1e9 / ns_per_op << ", \"allocations\": " << median.allocations
+            << ", \"allocated_bytes\": " << median.allocated_bytes;
+        if (counters.available())
+            out << ", \"cache_references\": " << median.cache_references << ", \"cache_misses\": " << median.cache_misses;
+        else
+            out << ", \"cache_references\": null, \"cache_misses\": null";
+        out << "}";
+        results.push_back(out.str());
+        std::cerr << name << " (" << payload_bytes << " B, n=" << n << "): " << ns_per_op << " ns/op\n";
+    }
+
+    void write(std::ostream& os) const
+    {
+        char when[32];
+        auto now = std::time(nullptr);
+        std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        os << "{\n  \"schema\": 1,\n  \"timestamp\": \"" << when << "\",\n  \"compiler\": \"" << __VERSION__
+           << "\",\n  \"build_type\": \"" << CONTAINERS_BUILD_TYPE << "\",\n  \"repetitions\": " << options.reps
+           << ",\n  \"perf_counters\": " << (counters.available() ? "true" : "false");
+        if (!counters.available())
+            os << ",\n  \"perf_counters_error\": \"" << counters.unavailable_reason() << "\"";
+        os << ",\n  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i)
+            os << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+        os << "  ]\n}\n";
+    }
+
+private:
+    Options options;
+    CacheCounters counters;
+    std::vector<std::string> results;
+};
+
+// ---- payloads ------------------------------------------------------------------
+
+/// Bytes of satellite data ordered by its first word
+template <std::size_t Bytes>
+struct Payload {
+    static_assert(Bytes % 8 == 0 && Bytes >= 8, "payloads are whole words");
+
+    std::array<std::uint64_t, Bytes / 8> words {};
+
+    std::uint64_t key() const { return words[0]; }
+    static Payload make(std::uint64_t k)
+    {
+        Payload p;
+        p.words.fill(k);
+        return p;
+    }
+    friend bool operator<(const Payload& a, const Payload& b) { return a.key() < b.key(); }
+    friend bool operator>(const Payload& a, const Payload& b) { return a.key() > b.key(); }
+};
+
+/// random values, and a push/pop pattern that never pops an empty container
+struct Inputs {
+    Inputs(std::size_t n, std::mt19937_64& rng)
+        : values(n)
+        , indexes(n)
+        , pushes(n)
+    {
+        for (auto& v : values)
+            v = rng();
+        for (auto& i : indexes)
+            i = rng() % n;
+        std::size_t live = n / 2;
+        for (auto& push : pushes) {
+            push = live == 0 || rng() % 2;
+            live += push ? 1 : -1;
+        }
+    }
+
+    std::vector<std::uint64_t> values;
+    std::vector<std::size_t> indexes;
+    std::vector<char> pushes;
+};
+
+// ---- workloads -------------------------------------------------------------------
+
+template <typename P, typename Vector>
+void sequence_workloads(Suite& suite, const char* name, bool baseline, std::size_t n, const Inputs& in)
+{
+    auto empty = [] { return Vector(); };
+    auto filled = [&, n] {
+        Vector v;
+        for (std::size_t i = 0; i < n; ++i)
+            v.push_back(P::make(in.values[i]));
+        return v;
+    };
+
+    suite.run(name, baseline, "push_back", sizeof(P), n, empty, [&, n](Vector& v) {
+        for (std::size_t i = 0; i < n; ++i)
+            v.push_back(P::make(in.values[i]));
+        return n;
+    });
+    suite.run(name, baseline, "bulk_build", sizeof(P), n, empty, [&, n](Vector& v) {
+        v.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            v.push_back(P::make(in.values[i]));
+        return n;
+    });
+    suite.run(name, baseline, "sequential_read", sizeof(P), n, filled, [n](Vector& v) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += v[i].key();
+        keep(sum);
+        return n;
+    });
+    suite.run(name, baseline, "random_read", sizeof(P), n, filled, [&, n](Vector& v) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += v[in.indexes[i]].key();
+        keep(sum);
+        return n;
+    });
+    auto half = [&, n] {
+        Vector v;
+        for (std::size_t i = 0; i < n / 2; ++i)
+            v.push_back(P::make(in.values[i]));
+        return v;
+    };
+    suite.run(name, baseline, "push_pop_mix", sizeof(P), n, half, [&, n](Vector& v) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (in.pushes[i])
+                v.push_back(P::make(in.values[i]));
+            else
+                v.pop_back();
+        }
+        return n;
+    });
+}
+
+/// the min-heap in Heap.hpp and std::priority_queue behind one interface
+template <typename P>
+struct MinHeap {
+    void push(const P& p) { heap.add(p); }
+    P pop() { return heap.extract_min(); }
+    Heap<P> heap;
+};
+
+template <typename P>
+struct StdMinHeap {
+    void push(const P& p) { heap.push(p); }
+    P pop()
+    {
+        auto top = heap.top();
+        heap.pop();
+        return top;
+    }
+    std::priority_queue<P, std::vector<P>, std::greater<P>> heap;
+};
+
+template <typename P, typename Queue>
+void priority_queue_workloads(Suite& suite, const char* name, bool baseline, std::size_t n, const Inputs& in)
+{
+    suite.run(name, baseline, "push_then_pop", sizeof(P), n, [] { return Queue(); }, [&, n](Queue& q) {
+        for (std::size_t i = 0; i < n; ++i)
+            q.push(P::make(in.values[i]));
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += q.pop().key();
+        keep(sum);
+        return 2 * n;
+    });
+    auto half = [&, n] {
+        Queue q;
+        for (std::size_t i = 0; i < n / 2; ++i)
+            q.push(P::make(in.values[i]));
+        return q;
+    };
+    suite.run(name, baseline, "push_pop_mix", sizeof(P), n, half, [&, n](Queue& q) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (in.pushes[i])
+                q.push(P::make(in.values[i]));
+            else
+                sum += q.pop().key();
+        }
+        keep(sum);
+        return n;
+    });
+}
+
+template <typename P>
+void heap_build_workloads(Suite& suite, std::size_t n, const Inputs& in)
+{
+    std::vector<P> input(n);
+    for (std::size_t i = 0; i < n; ++i)
+        input[i] = P::make(in.values[i]);
+    auto nothing = [] { return 0; };
+
+    /// each copies the input and then max-heapifies it
+    suite.run("simple_heap::Heap", false, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        simple_heap::Heap<P> heap(input);
+        keep(heap[0]);
+        return n;
+    });
+    suite.run("parallel_heapify", false, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        auto heap = input;
+        parallel_heapify::build_max_heap(heap);
+        keep(heap[0]);
+        return n;
+    });
+    suite.run("std::make_heap", true, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        auto heap = input;
+        std::make_heap(heap.begin(), heap.end());
+        keep(heap[0]);
+        return n;
+    });
+}
+
+template <typename P>
+void ordered_map_workloads(Suite& suite, std::size_t n, const Inputs& in)
+{
+    /// distinct 32-bit keys in random order
+    std::vector<std::pair<std::uint32_t, P>> pairs(n);
+    for (std::size_t i = 0; i < n; ++i)
+        pairs[i] = { static_cast<std::uint32_t>(i * 2654435761u), P::make(in.values[i]) };
+    std::vector<std::uint32_t> random_keys(n), sequential_keys(n);
+    for (std::size_t i = 0; i < n; ++i)
+        random_keys[i] = pairs[in.indexes[i]].first;
+    for (std::size_t i = 0; i < n; ++i)
+        sequential_keys[i] = pairs[i].first;
+    std::sort(sequential_keys.begin(), sequential_keys.end());
+
+    using Flat = FlatMap<std::uint32_t, P>;
+    auto nothing = [] { return 0; };
+    auto lookups = [&](const char* name, bool baseline, auto build, auto find) {
+        suite.run(name, baseline, "random_lookup", sizeof(P), n, build, [&, n](auto& map) {
+            std::uint64_t sum = 0;
+            for (auto k : random_keys)
+                sum += find(map, k).key();
+            keep(sum);
+            return n;
+        });
+        suite.run(name, baseline, "sequential_lookup", sizeof(P), n, build, [&, n](auto& map) {
+            std::uint64_t sum = 0;
+            for (auto k : sequential_keys)
+                sum += find(map, k).key();
+            keep(sum);
+            return n;
+        });
+    };
+
+    auto flat_find = [](Flat& map, std::uint32_t k) -> const P& { return *map.find(k); };
+    auto std_find = [](auto& map, std::uint32_t k) -> const P& { return map.find(k)->second; };
+
+    suite.run("FlatMap", false, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        Flat map(pairs.begin(), pairs.end());
+        keep(map.size());
+        return n;
+    });
+    suite.run("FlatMap eytzinger", false, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        Flat map(pairs.begin(), pairs.end(), Flat::Layout::eytzinger);
+        keep(map.size());
+        return n;
+    });
+    suite.run("std::map", true, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        std::map<std::uint32_t, P> map(pairs.begin(), pairs.end());
+        keep(map.size());
+        return n;
+    });
+    suite.run("std::unordered_map", true, "bulk_build", sizeof(P), n, nothing, [&, n](int&) {
+        std::unordered_map<std::uint32_t, P> map(pairs.begin(), pairs.end());
+        keep(map.size());
+        return n;
+    });
+
+    lookups("FlatMap", false, [&] { return Flat(pairs.begin(), pairs.end()); }, flat_find);
+    lookups("FlatMap eytzinger", false, [&] { return Flat(pairs.begin(), pairs.end(), Flat::Layout::eytzinger); }, flat_find);
+    lookups("std::map", true, [&] { return std::map<std::uint32_t, P>(pairs.begin(), pairs.end()); }, std_find);
+    lookups("std::unordered_map", true, [&] { return std::unordered_map<std::uint32_t, P>(pairs.begin(), pairs.end()); }, std_find);
+}
+
+template <typename P>
+void direct_address_workloads(Suite& suite, std::size_t n, const Inputs& in)
+{
+    using Table = DirectAddressTable<P>;
+    using Map = std::unordered_map<std::uint32_t, P>;
+    struct Handles {
+        Table table;
+        std::vector<typename Table::Entry> entries;
+    };
+
+    auto empty_table = [&, n] {
+        Handles s { Table(n), std::vector<typename Table::Entry>(n) };
+        for (std::size_t i = 0; i < n; ++i)
+            s.entries[i].satellite = P::make(in.values[i]);
+        return s;
+    };
+    auto full_table = [&] {
+        auto s = empty_table();
+        for (auto& e : s.entries)
+            s.table.Insert(e);
+        return s;
+    };
+    /// the std equivalent of dense handles: the index as a hash key
+    auto full_map = [&, n] {
+        Map map;
+        for (std::size_t i = 0; i < n; ++i)
+            map.emplace(static_cast<std::uint32_t>(i), P::make(in.values[i]));
+        return map;
+    };
+
+    suite.run("DirectAddressTable", false, "insert", sizeof(P), n, empty_table, [n](Handles& s) {
+        for (auto& e : s.entries)
+            s.table.Insert(e);
+        return n;
+    });
+    suite.run("std::unordered_map", true, "insert", sizeof(P), n, [] { return Map(); }, [&, n](Map& map) {
+        for (std::size_t i = 0; i < n; ++i)
+            map.emplace(static_cast<std::uint32_t>(i), P::make(in.values[i]));
+        return n;
+    });
+
+    suite.run("DirectAddressTable", false, "random_lookup", sizeof(P), n, full_table, [&, n](Handles& s) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += s.table.Search(s.entries[in.indexes[i]].key)->key();
+        keep(sum);
+        return n;
+    });
+    suite.run("std::unordered_map", true, "random_lookup", sizeof(P), n, full_map, [&, n](Map& map) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += map.find(static_cast<std::uint32_t>(in.indexes[i]))->second.key();
+        keep(sum);
+        return n;
+    });
+
+    suite.run("DirectAddressTable", false, "sequential_lookup", sizeof(P), n, full_table, [n](Handles& s) {
+        std::uint64_t sum = 0;
+        for (auto& e : s.entries)
+            sum += s.table.Search(e.key)->key();
+        keep(sum);
+        return n;
+    });
+    suite.run("std::unordered_map", true, "sequential_lookup", sizeof(P), n, full_map, [n](Map& map) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += map.find(static_cast<std::uint32_t>(i))->second.key();
+        keep(sum);
+        return n;
+    });
+
+    /// each op deletes a random live entry and inserts it again
+    suite.run("DirectAddressTable", false, "delete_insert_mix", sizeof(P), n, full_table, [&, n](Handles& s) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto& e = s.entries[in.indexes[i]];
+            s.table.Delete(e);
+            s.table.Insert(e);
+        }
+        return 2 * n;
+    });
+    suite.run("std::unordered_map", true, "delete_insert_mix", sizeof(P), n, full_map, [&, n](Map& map) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto k = static_cast<std::uint32_t>(in.indexes[i]);
+            map.erase(k);
+            map.emplace(k, P::make(in.values[i]));
+        }
+        return 2 * n;
+    });
+}
+
+template <typename P>
+void all_workloads(Suite& suite, std::mt19937_64& rng)
+{
+    /// keep each container's data near 64 MiB whatever the payload
+    auto n = std::max<std::size_t>(1, std::min(suite.config().size, (std::size_t(64) << 20) / sizeof(P)));
+    Inputs in(n, rng);
+
+    sequence_workloads<P, SmallVector<P>>(suite, "SmallVector", false, n, in);
+    sequence_workloads<P, std::vector<P>>(suite, "std::vector", true, n, in);
+    priority_queue_workloads<P, MinHeap<P>>(suite, "Heap", false, n, in);
+    priority_queue_workloads<P, StdMinHeap<P>>(suite, "std::priority_queue", true, n, in);
+    heap_build_workloads<P>(suite, n, in);
+    ordered_map_workloads<P>(suite, n, in);
+    direct_address_workloads<P>(suite, n, in);
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&] {
+            if (i + 1 >= argc) {
+                std::cerr << arg << " needs a value\n";
+                std::exit(2);
+            }
+            return std::string(argv[++i]);
+        };
+        if (arg == "--quick") {
+            options.size = std::size_t(1) << 12;
+            options.reps = 3;
+        } else if (arg == "--size") {
+            options.size = std::stoull(value());
+        } else if (arg == "--reps") {
+            options.reps = std::max(1u, static_cast<unsigned>(std::stoul(value())));
+        } else if (arg == "--filter") {
+            options.filter = value();
+        } else if (arg == "-o") {
+            output = value();
+        } else {
+            std::cerr << "usage: containers_bench [--quick] [--size N] [--reps R] [--filter S] [-o FILE]\n";
+            return 2;
+        }
+    }
+
+    Suite suite(options);
+    std::mt19937_64 rng(42);
+    all_workloads<Payload<8>>(suite, rng);
+    all_workloads<Payload<64>>(suite, rng);
+    all_workloads<Payload<256>>(suite, rng);
+
+    if (output.empty()) {
+        suite.write(std::cout);
+    } else {
+        std::ofstream file(output);
+        suite.write(file);
+    }
+    return 0;
+}